@@ -0,0 +1,120 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// The replacements live in their own translation unit: where GCC can
+// inline them, it sees memory from operator new released by free() and
+// warns about a mismatch.
+static std::atomic<std::size_t> allocations{0};
+
+std::size_t allocation_count() {
+  return allocations.load(std::memory_order_relaxed);
+}
+
+static void* allocate(std::size_t size, std::size_t alignment) noexcept {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  const std::size_t bytes = size == 0 ? 1 : size;
+  if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+    return std::malloc(bytes);
+  }
+  // aligned_alloc() takes a multiple of the alignment.
+  return std::aligned_alloc(
+      alignment, (bytes + alignment - 1) / alignment * alignment);
+}
+
+static void* allocate_or_throw(std::size_t size, std::size_t alignment) {
+  if (void* pointer = allocate(size, alignment)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) {
+  return allocate_or_throw(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](std::size_t size) {
+  return allocate_or_throw(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  return allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(
+    std::size_t size, std::align_val_t alignment,
+    const std::nothrow_t&) noexcept {
+  return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](
+    std::size_t size, std::align_val_t alignment,
+    const std::nothrow_t&) noexcept {
+  return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+// malloc() and aligned_alloc() memory are both released by free(), so every
+// form of operator delete is the same.
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](
+    void* pointer, std::size_t, std::align_val_t) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(
+    void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](
+    void* pointer, std::align_val_t, const std::nothrow_t&) noexcept {
+  std::free(pointer);
+}
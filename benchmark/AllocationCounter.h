@@ -0,0 +1,10 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+
+// Heap allocations made by the benchmark binary so far. Every form of
+// operator new is replaced in AllocationCounter.cpp to count them.
+std::size_t allocation_count();
@@ -4,6 +4,7 @@
 #include <benchmark/benchmark.h>
 
 #include "BasisFilter.h"
+#include "BasisGenerator.h"
 #include "BosonicBasis.h"
 #include "FermionicBasis.h"
 #include "GenericBasis.h"
@@ -64,6 +65,18 @@ static void BM_CreateFermionicBasisWithFilter(benchmark::State& state) {
 BENCHMARK(BM_CreateFermionicBasisWithFilter)
     ->ArgsProduct({basis_range, basis_range});
 
+static void BM_CreateFermionicBasisWithStaticFilter(benchmark::State& state) {
+  for (auto _ : state) {
+    FermionicBasis basis(
+        /*orbitals*/ state.range(0), /*particles*/ state.range(1),
+        total_spin_filter(0));
+    benchmark::DoNotOptimize(basis);
+  }
+}
+
+BENCHMARK(BM_CreateFermionicBasisWithStaticFilter)
+    ->ArgsProduct({basis_range, basis_range});
+
 static void BM_CreateBosonicBasisWithFilter(benchmark::State& state) {
   for (auto _ : state) {
     BosonicBasis basis(
@@ -75,3 +88,13 @@ static void BM_CreateBosonicBasisWithFilter(benchmark::State& state) {
 
 BENCHMARK(BM_CreateBosonicBasisWithFilter)
     ->ArgsProduct({basis_range, basis_range});
+
+static void BM_StreamFermionicBasis(benchmark::State& state) {
+  for (auto _ : state) {
+    FermionicBasisGenerator generator(
+        /*orbitals*/ state.range(0), /*particles*/ state.range(1));
+    benchmark::DoNotOptimize(generator.count());
+  }
+}
+
+BENCHMARK(BM_StreamFermionicBasis)->ArgsProduct({basis_range, basis_range});
@@ -0,0 +1,341 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "Expression.h"
+#include "ExpressionTemplates.h"
+#include "ExpressionText.h"
+#include "InternedExpression.h"
+#include "NestedCommutator.h"
+#include "NormalOrderer.h"
+#include "SortedExpression.h"
+
+using enum Operator::Statistics;
+using enum Operator::Spin;
+
+// Allocations per iteration, and per term of the result.
+static void report_allocations(
+    benchmark::State& state, std::size_t count, std::size_t terms) {
+  const auto iterations = static_cast<double>(state.iterations());
+  state.counters["allocations"] =
+      static_cast<double>(count) / iterations;
+  state.counters["allocations_per_term"] =
+      static_cast<double>(count) / iterations /
+      static_cast<double>(terms == 0 ? 1 : terms);
+}
+
+static void BM_BuildHeisenbergHamiltonian(benchmark::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    Expression result;
+    for (std::size_t i = 0; i < size; i++) {
+      result += spin_x(i) * spin_x((i + 1) % size);
+      result += spin_y(i) * spin_y((i + 1) % size);
+      result += spin_z(i) * spin_z((i + 1) % size);
+    }
+    benchmark::DoNotOptimize(result.size());
+  }
+}
+
+BENCHMARK(BM_BuildHeisenbergHamiltonian)->Range(64, 1 << 14);
+
+static void BM_BuildHeisenbergHamiltonianLazy(benchmark::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    Expression result;
+    for (std::size_t i = 0; i < size; i++) {
+      result += lazy(spin_x(i)) * lazy(spin_x((i + 1) % size));
+      result += lazy(spin_y(i)) * lazy(spin_y((i + 1) % size));
+      result += lazy(spin_z(i)) * lazy(spin_z((i + 1) % size));
+    }
+    benchmark::DoNotOptimize(result.size());
+  }
+}
+
+BENCHMARK(BM_BuildHeisenbergHamiltonianLazy)->Range(64, 1 << 14);
+
+static Expression heisenberg_bond(std::size_t i, std::size_t j) {
+  Expression result;
+  result += lazy(spin_x(i)) * lazy(spin_x(j));
+  result += lazy(spin_y(i)) * lazy(spin_y(j));
+  result += lazy(spin_z(i)) * lazy(spin_z(j));
+  return result;
+}
+
+// [H, S_z(0)] and {H, S_z(0)} for a Heisenberg chain.
+static void BM_CommuteExpressions(benchmark::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  Expression hamiltonian;
+  for (std::size_t i = 0; i < size; i++) {
+    hamiltonian += heisenberg_bond(i, (i + 1) % size);
+  }
+  const Expression sz = spin_z(0);
+
+  std::size_t terms = 0;
+  const std::size_t before = allocation_count();
+  for (auto _ : state) {
+    Expression c = commute(hamiltonian, sz);
+    Expression a = anticommute(hamiltonian, sz);
+    terms = c.size() + a.size();
+    benchmark::DoNotOptimize(terms);
+  }
+  report_allocations(state, allocation_count() - before, terms);
+}
+
+BENCHMARK(BM_CommuteExpressions)->DenseRange(8, 32, 8);
+
+// Nested commutators of single terms, as in a Baker-Campbell-Hausdorff
+// expansion: [[a, b], a] with the algebra chained on temporaries.
+static void BM_CommuteTerms(benchmark::State& state) {
+  const auto size = static_cast<std::size_t>(state.range(0));
+  std::size_t terms = 0;
+  const std::size_t before = allocation_count();
+  for (auto _ : state) {
+    Expression result;
+    for (std::size_t i = 0; i + 1 < size; i++) {
+      Term a = one_body<Fermion>(1.0, Up, i, Up, i + 1);
+      Term b = density_density<Fermion>(2.0, Up, i, Down, i + 1);
+      Expression inner = commute(a, b);
+      result += commute(inner, Expression(std::vector<Term>{a}))
+                    .product(0.5)
+                    .negate();
+    }
+    terms = result.size();
+    benchmark::DoNotOptimize(terms);
+  }
+  report_allocations(state, allocation_count() - before, terms);
+}
+
+BENCHMARK(BM_CommuteTerms)->DenseRange(8, 32, 8);
+
+static Expression heisenberg_chain(std::size_t size) {
+  Expression hamiltonian;
+  for (std::size_t i = 0; i < size; i++) {
+    hamiltonian += heisenberg_bond(i, (i + 1) % size);
+  }
+  return hamiltonian;
+}
+
+// [[H, S_z(0)], H], with operator strings as keys.
+static void BM_NestedCommutator(benchmark::State& state) {
+  const Expression hamiltonian =
+      heisenberg_chain(static_cast<std::size_t>(state.range(0)));
+  const Expression sz = spin_z(0);
+  for (auto _ : state) {
+    Expression result = commute(commute(hamiltonian, sz), hamiltonian);
+    benchmark::DoNotOptimize(result.size());
+  }
+}
+
+BENCHMARK(BM_NestedCommutator)->DenseRange(8, 32, 8);
+
+// Same with interned strings. The table is kept across iterations, as it
+// would be across the commutators of an expansion.
+static void BM_NestedCommutatorInterned(benchmark::State& state) {
+  OperatorStringTable table;
+  const InternedExpression hamiltonian(
+      table, heisenberg_chain(static_cast<std::size_t>(state.range(0))));
+  const InternedExpression sz(table, spin_z(0));
+  for (auto _ : state) {
+    InternedExpression result = commute(commute(hamiltonian, sz), hamiltonian);
+    benchmark::DoNotOptimize(result.size());
+  }
+  state.counters["strings"] = static_cast<double>(table.size());
+}
+
+BENCHMARK(BM_NestedCommutatorInterned)->DenseRange(8, 32, 8);
+
+// All c+(i, Up) c+(j, Down) c(l, Down) c(k, Up) on n orbitals, with every
+// `stride`-th term: n^4 / stride terms.
+static Expression two_body_terms(std::size_t n, std::size_t stride) {
+  Expression result;
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < n; i++) {
+    for (std::size_t j = 0; j < n; j++) {
+      for (std::size_t k = 0; k < n; k++) {
+        for (std::size_t l = 0; l < n; l++) {
+          if (count++ % stride != 0) {
+            continue;
+          }
+          result += Term(
+              1.0 / static_cast<double>(count),
+              {Operator::creation<Fermion>(Up, i),
+               Operator::creation<Fermion>(Down, j),
+               Operator::annihilation<Fermion>(Down, l),
+               Operator::annihilation<Fermion>(Up, k)});
+        }
+      }
+    }
+  }
+  return result;
+}
+
+// Sums, scaling and comparison of two large expressions, as hash maps and
+// as sorted arrays.
+static void BM_SumExpressions(benchmark::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const Expression a = two_body_terms(n, 1);
+  const Expression b = two_body_terms(n, 3);
+  for (auto _ : state) {
+    Expression result = (a + b).product(2.0);
+    benchmark::DoNotOptimize(result == a);
+  }
+}
+
+BENCHMARK(BM_SumExpressions)->RangeMultiplier(2)->Range(4, 16);
+
+static void BM_SumSortedExpressions(benchmark::State& state) {
+  const auto n = static_cast<std::size_t>(state.range(0));
+  const SortedExpression a(two_body_terms(n, 1));
+  const SortedExpression b(two_body_terms(n, 3));
+  for (auto _ : state) {
+    SortedExpression result = 2.0 * (a + b);
+    benchmark::DoNotOptimize(result == a);
+  }
+}
+
+BENCHMARK(BM_SumSortedExpressions)->RangeMultiplier(2)->Range(4, 16);
+
+// H^2 for a two-body Hamiltonian with n^4 terms.
+static void BM_SquareExpression(benchmark::State& state) {
+  const Expression h =
+      two_body_terms(static_cast<std::size_t>(state.range(0)), 1);
+  for (auto _ : state) {
+    Expression square = h * h;
+    benchmark::DoNotOptimize(square.size());
+  }
+}
+
+BENCHMARK(BM_SquareExpression)->DenseRange(3, 5)->UseRealTime();
+
+// Normal-ordered H^2, with the product built first and fused.
+static void BM_NormalOrderSquare(benchmark::State& state) {
+  const Expression h =
+      two_body_terms(static_cast<std::size_t>(state.range(0)), 1);
+  for (auto _ : state) {
+    Expression square = NormalOrderer(h * h).expression();
+    benchmark::DoNotOptimize(square.size());
+  }
+}
+
+BENCHMARK(BM_NormalOrderSquare)->DenseRange(3, 5)->UseRealTime();
+
+static void BM_NormalOrderedSquare(benchmark::State& state) {
+  const Expression h =
+      two_body_terms(static_cast<std::size_t>(state.range(0)), 1);
+  for (auto _ : state) {
+    Expression square = normal_ordered_product(h, h);
+    benchmark::DoNotOptimize(square.size());
+  }
+}
+
+BENCHMARK(BM_NormalOrderedSquare)->DenseRange(3, 5)->UseRealTime();
+
+// Heisenberg model with couplings 1 / r^3 between all pairs of sites.
+static Expression dipolar_chain(std::size_t size) {
+  Expression hamiltonian;
+  for (std::size_t i = 0; i < size; i++) {
+    for (std::size_t j = i + 1; j < size; j++) {
+      const double r = static_cast<double>(j - i);
+      hamiltonian += (1.0 / (r * r * r)) * heisenberg_bond(i, j);
+    }
+  }
+  return hamiltonian;
+}
+
+// [[H, S_x(0)], H], keeping every term or dropping those below 1e-3.
+static void BM_NestedCommutatorTolerance(benchmark::State& state) {
+  Expression hamiltonian = dipolar_chain(8);
+  hamiltonian.set_tolerance(static_cast<double>(state.range(0)) * 1e-3);
+  const Expression sx = spin_x(0);
+  std::size_t terms = 0;
+  double discarded = 0.0;
+  for (auto _ : state) {
+    Expression result = commute(commute(hamiltonian, sx), hamiltonian);
+    terms = result.size();
+    discarded = result.discarded();
+    benchmark::DoNotOptimize(terms);
+  }
+  state.counters["terms"] = static_cast<double>(terms);
+  state.counters["discarded"] = discarded;
+}
+
+BENCHMARK(BM_NestedCommutatorTolerance)->Arg(0)->Arg(1)->Arg(10);
+
+// e^S H e^-S to third order, with every order computed from scratch as in
+// a user loop, and incrementally.
+static void BM_BchFromScratch(benchmark::State& state) {
+  Expression hamiltonian = dipolar_chain(6);
+  hamiltonian.set_tolerance(1e-6);
+  Expression s = spin_x(0);
+  s *= Term::CoeffType(0.0, 0.1);
+  for (auto _ : state) {
+    Expression result = hamiltonian;
+    double factorial = 1.0;
+    for (std::size_t k = 1; k <= 3; k++) {
+      Expression nested = hamiltonian;
+      for (std::size_t j = 0; j < k; j++) {
+        nested = commute(s, nested);
+      }
+      factorial *= static_cast<double>(k);
+      result += std::move(nested).product(1.0 / factorial);
+    }
+    benchmark::DoNotOptimize(result.size());
+  }
+}
+
+BENCHMARK(BM_BchFromScratch);
+
+static void BM_BchTransform(benchmark::State& state) {
+  Expression hamiltonian = dipolar_chain(6);
+  hamiltonian.set_tolerance(1e-6);
+  Expression s = spin_x(0);
+  s *= Term::CoeffType(0.0, 0.1);
+  for (auto _ : state) {
+    Expression result = bch_transform(s, hamiltonian, 3);
+    benchmark::DoNotOptimize(result.size());
+  }
+}
+
+BENCHMARK(BM_BchTransform);
+
+// Loading integrals from text, parsed in bulk, against adding the same
+// terms one at a time.
+static void BM_ParseExpressionText(benchmark::State& state) {
+  std::ostringstream out;
+  write_expression_text(
+      out, two_body_terms(static_cast<std::size_t>(state.range(0)), 1));
+  const std::string text = out.str();
+  for (auto _ : state) {
+    auto expression = parse_expression(text);
+    benchmark::DoNotOptimize(expression->size());
+  }
+  state.SetBytesProcessed(
+      state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+BENCHMARK(BM_ParseExpressionText)->RangeMultiplier(2)->Range(8, 16);
+
+static void BM_AddTerms(benchmark::State& state) {
+  const Expression terms =
+      two_body_terms(static_cast<std::size_t>(state.range(0)), 1);
+  std::vector<Term> list;
+  for (const auto& [operators, coefficient] : terms.terms()) {
+    list.emplace_back(coefficient, operators);
+  }
+  for (auto _ : state) {
+    Expression expression;
+    for (const Term& term : list) {
+      expression += term;
+    }
+    benchmark::DoNotOptimize(expression.size());
+  }
+}
+
+BENCHMARK(BM_AddTerms)->RangeMultiplier(2)->Range(8, 16);
@@ -3,6 +3,10 @@
 
 #include <benchmark/benchmark.h>
 
+#include <numeric>
+
+#include "DiagonalKernel.h"
+#include "Fcidump.h"
 #include "FermionicBasis.h"
 #include "Models/HubbardChain.h"
 #include "SparseMatrix.h"
@@ -28,3 +32,97 @@ static void BM_CreateHubbardChainMatrixElements(benchmark::State& state) {
 
 BENCHMARK(BM_CreateHubbardChainMatrixElements)
     ->ArgsProduct({basis_range, basis_range});
+
+static void BM_CreateHubbardChainMatrixElementsDeterministic(
+    benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    const std::size_t size = state.range(0);
+    const std::size_t particles = state.range(1);
+    HubbardChain model(0.0, 1.0, 2.0, size);
+    FermionicBasis basis(size, particles);
+    SparseMatrix<std::complex<double>> m;
+    state.ResumeTiming();
+    model.compute_matrix_elements(
+        basis, m, HubbardChain::Assembly::Deterministic);
+  }
+}
+
+BENCHMARK(BM_CreateHubbardChainMatrixElementsDeterministic)
+    ->ArgsProduct({basis_range, basis_range});
+
+static void BM_EvaluateHubbardDiagonal(benchmark::State& state) {
+  const auto level = static_cast<SimdLevel>(state.range(0));
+  if (level > simd_level()) {
+    state.SkipWithError("instruction set not supported");
+    return;
+  }
+  const std::size_t size = 16;
+  Expression hamiltonian;
+  for (std::size_t i = 0; i < size; i++) {
+    hamiltonian += density_density<Fermion>(
+        4.0, Operator::Spin::Up, i, Operator::Spin::Down, i);
+    hamiltonian += spin_z(i) * spin_z((i + 1) % size);
+  }
+  DiagonalOperator diagonal = DiagonalOperator::split(hamiltonian, size);
+  std::vector<std::uint64_t> words(1 << 16);
+  for (std::size_t i = 0; i < words.size(); i++) {
+    words[i] = i * 0x9e3779b97f4a7c15;
+  }
+  std::vector<double> energies(words.size());
+  for (auto _ : state) {
+    evaluate_diagonal(diagonal, words, energies, level);
+    benchmark::DoNotOptimize(energies.data());
+  }
+  state.SetItemsProcessed(
+      static_cast<std::int64_t>(state.iterations() * words.size()));
+  state.SetLabel(simd_level_name(level));
+}
+
+BENCHMARK(BM_EvaluateHubbardDiagonal)->DenseRange(0, 2);
+
+static void BM_BuildHubbardChainAllSectors(benchmark::State& state) {
+  const std::size_t size = state.range(0);
+  HubbardChain model(0.0, 1.0, 2.0, size);
+  std::vector<std::size_t> particles(2 * size + 1);
+  std::iota(particles.begin(), particles.end(), 0);
+  for (auto _ : state) {
+    auto blocks = model.sector_blocks(size, particles);
+    benchmark::DoNotOptimize(blocks.data());
+  }
+}
+
+BENCHMARK(BM_BuildHubbardChainAllSectors)->DenseRange(6, 8, 2);
+
+// Dense integrals of `n` orbitals, 2n spin orbitals.
+static Fcidump dense_integrals(std::size_t n) {
+  Fcidump result;
+  result.orbitals = n;
+  for (std::size_t i = 0; i < n; i++) {
+    for (std::size_t j = 0; j <= i; j++) {
+      result.one_body.push_back({i, j, -1.0 / static_cast<double>(1 + i + j)});
+      for (std::size_t k = 0; k <= i; k++) {
+        for (std::size_t l = 0; l <= (k == i ? j : k); l++) {
+          result.two_body.push_back(
+              {{i, j, k, l}, 1.0 / static_cast<double>(1 + i + j + k + l)});
+        }
+      }
+    }
+  }
+  return result;
+}
+
+static void BM_MolecularHamiltonian(benchmark::State& state) {
+  const Fcidump integrals =
+      dense_integrals(static_cast<std::size_t>(state.range(0)));
+  std::size_t terms = 0;
+  for (auto _ : state) {
+    Expression hamiltonian = molecular_hamiltonian(integrals);
+    terms = hamiltonian.size();
+    benchmark::DoNotOptimize(terms);
+  }
+  state.counters["integrals"] = static_cast<double>(integrals.two_body.size());
+  state.counters["terms"] = static_cast<double>(terms);
+}
+
+BENCHMARK(BM_MolecularHamiltonian)->RangeMultiplier(2)->Range(4, 16);
@@ -1,14 +1,18 @@
 // Copyright (c) 2024 Matheus Sousa
 // SPDX-License-Identifier: BSD-2-Clause
 
-#include <armadillo>
+#include <algorithm>
 #include <array>
-#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
 
-#include "Assert.h"
-#include "Basis.h"
-#include "FermionicBasis.h"
+#include "BasisFilter.h"
 #include "Models/HubbardSquare.h"
+#include "SectorSolver.h"
+#include "SymmetricBasis.h"
 
 // Table 2 of https://journals.aps.org/prb/pdf/10.1103/PhysRevB.45.10741
 constexpr static std::array<double, 4> hubbardModelU = {20, 10, 8, 4};
@@ -31,27 +35,69 @@ constexpr static std::array<std::array<double, 4>, 15> hubbardModelTable = {
      {-3.73991, -7.02900, -8.46888, -13.62185}}     // 16 electrons
 };
 
-int main() {
-  const std::size_t rowsToTake = 4;
+// Symmetry sectors of the 4x4 torus. Every SU(2) multiplet has a state with
+// the smallest |Sz|, and momenta related by the point group have the same
+// spectrum, so it is enough to look at the inequivalent momenta. Those left
+// invariant by rotations (or by inversion) are split further by them.
+static std::vector<SymmetryGroup> sectors(std::size_t n) {
+  std::vector<SymmetryGroup> result;
+  for (auto [kx, ky] : std::vector<std::pair<std::size_t, std::size_t>>{
+           {0, 0}, {1, 0}, {1, 1}, {2, 0}, {2, 1}, {2, 2}}) {
+    SymmetryGroup translations = translation_symmetry(n, n, kx, ky);
+    if (kx == ky && (kx == 0 || 2 * kx == n)) {
+      for (int m = 0; m < 4; m++) {
+        result.push_back(translations * rotation_symmetry(n, m));
+      }
+    } else if (2 * kx % n == 0 && 2 * ky % n == 0) {
+      for (int parity : {1, -1}) {
+        result.push_back(translations * inversion_symmetry(n, n, parity));
+      }
+    } else {
+      result.push_back(translations);
+    }
+  }
+  return result;
+}
+
+int main(int argc, char** argv) {
+  const std::size_t rowsToTake = argc > 1 ? std::stoul(argv[1]) : 4;
   std::cout << "Result:   Expected:" << std::endl;
 
-  for (std::size_t row = 0; row < rowsToTake; row++) {
-    for (std::size_t uidx = 0; uidx < hubbardModelU.size(); uidx++) {
-      const double t = 1.0;
-      const double u = hubbardModelU[uidx];
-      const std::size_t nx = 4;
-      const std::size_t ny = 4;
+  const std::size_t nx = 4;
+  const std::size_t ny = 4;
+  const std::vector<SymmetryGroup> groups = sectors(nx);
 
-      HubbardSquare model(t, u, nx, ny);
-      FermionicBasis basis(model.size(), row + 2);
+  std::vector<std::unique_ptr<HubbardSquare>> models;
+  std::vector<const Model*> pointers;
+  for (double u : hubbardModelU) {
+    models.push_back(std::make_unique<HubbardSquare>(1.0, u, nx, ny));
+    pointers.push_back(models.back().get());
+  }
 
-      arma::SpMat<arma::cx_double> mat(basis.size(), basis.size());
-      model.compute_matrix_elements(basis, mat);
-      LIBMB_ASSERT(mat.is_hermitian());
+  // Every (electrons, sector) basis is an independent job, shared by the
+  // blocks of all the values of U.
+  SectorSolver solver;
+  for (std::size_t row = 0; row < rowsToTake; row++) {
+    const std::size_t particles = row + 2;
+    for (const SymmetryGroup& group : groups) {
+      solver.add(pointers, [&group, particles]() {
+        return std::make_unique<SymmetricBasis>(
+            nx * ny, particles, group,
+            new TotalSpinFilter(static_cast<int>(particles % 2)));
+      });
+    }
+  }
+  const std::vector<SectorSolver::Result> results = solver.run();
 
-      arma::cx_vec eigval;
-      arma::eigs_gen(eigval, mat, 1, "sr");
-      std::cout << eigval[0].real() << "   " << hubbardModelTable[row][uidx]
+  for (std::size_t row = 0; row < rowsToTake; row++) {
+    for (std::size_t uidx = 0; uidx < hubbardModelU.size(); uidx++) {
+      double energy = std::numeric_limits<double>::infinity();
+      for (std::size_t k = 0; k < groups.size(); k++) {
+        const std::size_t job = row * groups.size() + k;
+        energy = std::min(
+            energy, results[job * hubbardModelU.size() + uidx].value);
+      }
+      std::cout << energy << "   " << hubbardModelTable[row][uidx]
                 << std::endl;
     }
   }
@@ -3,6 +3,7 @@
 
 #include "Basis.h"
 
+#include <bit>
 #include <sstream>
 
 #include "Assert.h"
@@ -57,6 +58,48 @@ std::string state_string(const BasisElement& element, std::size_t orbitals) {
   return out.str();
 }
 
+std::uint64_t occupation_bits(const BasisElement& element) {
+  std::uint64_t bits = 0;
+  for (const auto& o : element) {
+    LIBMB_ASSERT(o.is_fermion() && o.type() == Operator::Type::Creation);
+    bits |= std::uint64_t{1}
+            << (2 * o.orbital() + static_cast<std::size_t>(o.spin()));
+  }
+  return bits;
+}
+
+BasisElement element_from_occupation_bits(std::uint64_t bits) {
+  BasisElement element;
+  element.reserve(static_cast<std::size_t>(std::popcount(bits)));
+  while (bits != 0) {
+    const auto spin_orbital = static_cast<std::size_t>(std::countr_zero(bits));
+    element.push_back(Operator::creation<Operator::Statistics::Fermion>(
+        static_cast<Operator::Spin>(spin_orbital % 2), spin_orbital / 2));
+    bits &= bits - 1;
+  }
+  return element;
+}
+
+std::optional<std::pair<std::uint64_t, int>> apply_operators(
+    const std::vector<Operator>& operators, std::uint64_t word) {
+  int sign = 1;
+  for (auto it = operators.rbegin(); it != operators.rend(); ++it) {
+    LIBMB_ASSERT(it->is_fermion());
+    const std::uint64_t bit =
+        std::uint64_t{1}
+        << (2 * it->orbital() + static_cast<std::size_t>(it->spin()));
+    const bool occupied = (word & bit) != 0;
+    if (occupied != (it->type() == Operator::Type::Annihilation)) {
+      return std::nullopt;
+    }
+    if (std::popcount(word & (bit - 1)) % 2 != 0) {
+      sign = -sign;
+    }
+    word ^= bit;
+  }
+  return std::make_pair(word, sign);
+}
+
 void Basis::generate_combinations(
     BasisElement& current, size_t first_orbital, size_t depth,
     size_t max_depth) {
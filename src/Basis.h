@@ -4,7 +4,10 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
+#include <optional>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "BasisFilter.h"
@@ -71,3 +74,25 @@ void prepare_up_and_down_representation(
     const BasisElement& element, std::vector<int>& up, std::vector<int>& down);
 
 std::string state_string(const BasisElement& element, std::size_t orbitals);
+
+// Fermionic states as occupation words: bit 2 * orbital + spin is set when
+// the spin-orbital is occupied. With at most 32 orbitals every state fits in
+// a single 64-bit word.
+std::uint64_t occupation_bits(const BasisElement& element);
+
+BasisElement element_from_occupation_bits(std::uint64_t bits);
+
+// Applies a string of fermionic operators, rightmost first, to the state with
+// the given occupation word. Returns the resulting word and the sign picked
+// up by moving the operators into place, or nothing if the state is
+// annihilated.
+std::optional<std::pair<std::uint64_t, int>> apply_operators(
+    const std::vector<Operator>& operators, std::uint64_t word);
+
+// Canonical order of occupation words. For states with the same number of
+// particles it matches the lexicographic order of BasisElement: the state
+// owning the lowest differing spin-orbital comes first.
+inline bool canonical_less(std::uint64_t a, std::uint64_t b) {
+  const std::uint64_t diff = a ^ b;
+  return (a & diff & (~diff + 1)) != 0;
+}
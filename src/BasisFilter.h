@@ -3,11 +3,22 @@
 
 #pragma once
 
+#include <concepts>
+#include <utility>
+
 #include "Assert.h"
 #include "Operator.h"
 
 using BasisElement = std::vector<Operator>;
 
+inline int total_spin(const BasisElement& element) {
+  int s = 0;
+  for (const auto& op : element) {
+    s += 2 * static_cast<int>(op.spin()) - 1;
+  }
+  return s;
+}
+
 class BasisFilter {
  public:
   virtual bool filter(const BasisElement&) const { return true; }
@@ -19,11 +30,7 @@ class TotalSpinFilter : public BasisFilter {
   TotalSpinFilter(int total_spin) : m_total_spin(total_spin) {}
 
   bool filter(const BasisElement& element) const override {
-    int s = 0;
-    for (const auto& op : element) {
-      s += 2 * static_cast<int>(op.spin()) - 1;
-    }
-    return s == m_total_spin;
+    return total_spin(element) == m_total_spin;
   }
 
   ~TotalSpinFilter() override {}
@@ -46,3 +53,92 @@ class SingleSpinBasisFilter : public BasisFilter {
  private:
   Operator::Spin m_spin;
 };
+
+// Compile-time filters. Any callable taking a BasisElement and returning a
+// bool can be wrapped in an ElementFilter and combined with &&, || and !.
+// The basis generators take the resulting type as a template parameter, so
+// the whole predicate is inlined into the enumeration instead of going
+// through a virtual BasisFilter::filter call for every state.
+//
+//   FermionicBasis basis(n, m, total_spin_filter(0) && ElementFilter(f));
+
+template <typename F>
+concept ElementPredicate = requires(const F& f, const BasisElement& e) {
+  { f(e) } -> std::convertible_to<bool>;
+};
+
+template <ElementPredicate F>
+class ElementFilter {
+ public:
+  constexpr explicit ElementFilter(F predicate)
+      : m_predicate(std::move(predicate)) {}
+
+  bool operator()(const BasisElement& element) const {
+    return m_predicate(element);
+  }
+
+ private:
+  F m_predicate;
+};
+
+template <typename L, typename R>
+auto operator&&(ElementFilter<L> lhs, ElementFilter<R> rhs) {
+  return ElementFilter(
+      [lhs = std::move(lhs), rhs = std::move(rhs)](const BasisElement& e) {
+        return lhs(e) && rhs(e);
+      });
+}
+
+template <typename L, typename R>
+auto operator||(ElementFilter<L> lhs, ElementFilter<R> rhs) {
+  return ElementFilter(
+      [lhs = std::move(lhs), rhs = std::move(rhs)](const BasisElement& e) {
+        return lhs(e) || rhs(e);
+      });
+}
+
+template <typename F>
+auto operator!(ElementFilter<F> filter) {
+  return ElementFilter([filter = std::move(filter)](const BasisElement& e) {
+    return !filter(e);
+  });
+}
+
+inline auto accept_all_filter() {
+  return ElementFilter([](const BasisElement&) { return true; });
+}
+
+inline auto total_spin_filter(int s) {
+  return ElementFilter(
+      [s](const BasisElement& e) { return total_spin(e) == s; });
+}
+
+inline auto single_spin_filter(Operator::Spin spin) {
+  return ElementFilter([spin](const BasisElement& e) {
+    LIBMB_ASSERT(e.size() == 1);
+    return e.back().spin() == spin;
+  });
+}
+
+// Runtime-polymorphic adapter, so that compile-time filters can still be
+// handed to every API taking a BasisFilter*.
+template <typename F>
+class ElementFilterAdapter final : public BasisFilter {
+ public:
+  explicit ElementFilterAdapter(ElementFilter<F> filter)
+      : m_filter(std::move(filter)) {}
+
+  bool filter(const BasisElement& element) const override {
+    return m_filter(element);
+  }
+
+  ~ElementFilterAdapter() override {}
+
+ private:
+  ElementFilter<F> m_filter;
+};
+
+template <typename F>
+BasisFilter* make_basis_filter(ElementFilter<F> filter) {
+  return new ElementFilterAdapter<F>(std::move(filter));
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "BasisGenerator.h"
+
+static Operator spin_orbital_creation(std::size_t spin_orbital) {
+  return Operator::creation<Operator::Statistics::Fermion>(
+      static_cast<Operator::Spin>(spin_orbital % 2), spin_orbital / 2);
+}
+
+FermionicBasisGenerator::Iterator::Iterator(
+    const FermionicBasisGenerator* generator)
+    : m_generator{generator} {
+  const std::size_t k = generator->m_particles;
+  if (k > 2 * generator->m_orbitals) {
+    return;
+  }
+
+  m_positions.resize(k);
+  m_element.reserve(k);
+  for (std::size_t i = 0; i < k; i++) {
+    m_positions[i] = i;
+    m_element.push_back(spin_orbital_creation(i));
+  }
+  m_done = false;
+
+  if (!accept()) {
+    advance();
+  }
+}
+
+void FermionicBasisGenerator::Iterator::advance() {
+  do {
+    if (!next_combination()) {
+      m_done = true;
+      return;
+    }
+  } while (!accept());
+}
+
+bool FermionicBasisGenerator::Iterator::next_combination() {
+  const std::size_t k = m_positions.size();
+  const std::size_t n = 2 * m_generator->m_orbitals;
+
+  // Rightmost position that can still move one step to the right.
+  std::size_t i = k;
+  while (i > 0 && m_positions[i - 1] == n - k + i - 1) {
+    i--;
+  }
+  if (i == 0) {
+    return false;
+  }
+
+  m_positions[i - 1]++;
+  m_element[i - 1] = spin_orbital_creation(m_positions[i - 1]);
+  for (std::size_t j = i; j < k; j++) {
+    m_positions[j] = m_positions[j - 1] + 1;
+    m_element[j] = spin_orbital_creation(m_positions[j]);
+  }
+  return true;
+}
+
+bool FermionicBasisGenerator::Iterator::accept() const {
+  if (!m_generator->m_allow_double_occupancy) {
+    for (std::size_t i = 1; i < m_positions.size(); i++) {
+      if (m_positions[i] / 2 == m_positions[i - 1] / 2) {
+        return false;
+      }
+    }
+  }
+  return m_generator->m_basis_filter->filter(m_element);
+}
+
+std::size_t FermionicBasisGenerator::count() const {
+  std::size_t result = 0;
+  for (auto it = begin(); it != end(); ++it) {
+    result++;
+  }
+  return result;
+}
@@ -0,0 +1,97 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <iterator>
+#include <vector>
+
+#include "BasisFilter.h"
+#include "Pointers/NonnullOwnPtr.h"
+
+// Lazily enumerates the states of a FermionicBasis, in the same (canonical)
+// order and with the same filtering, without storing them. Useful when the
+// states only have to be visited once, e.g. to count the size of a sector.
+//
+//   for (const BasisElement& state : FermionicBasisGenerator(n, m)) { ... }
+//
+// A state is a set of occupied spin-orbitals 2 * orbital + spin. The
+// canonical order is the lexicographic order of these sets, so we step from
+// one state to the next with the usual successor of m-combinations (Gosper's
+// hack would give the colexicographic order instead).
+class FermionicBasisGenerator {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = BasisElement;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const BasisElement*;
+    using reference = const BasisElement&;
+
+    Iterator() = default;
+
+    explicit Iterator(const FermionicBasisGenerator* generator);
+
+    reference operator*() const { return m_element; }
+
+    pointer operator->() const { return &m_element; }
+
+    Iterator& operator++() {
+      advance();
+      return *this;
+    }
+
+    void operator++(int) { advance(); }
+
+    friend bool operator==(const Iterator& it, std::default_sentinel_t) {
+      return it.m_done;
+    }
+
+   private:
+    void advance();
+    bool next_combination();
+    bool accept() const;
+
+    const FermionicBasisGenerator* m_generator = nullptr;
+    std::vector<std::size_t> m_positions;
+    BasisElement m_element;
+    bool m_done = true;
+  };
+
+  FermionicBasisGenerator(
+      std::size_t n, std::size_t m, BasisFilter* filter,
+      bool allow_double_occupancy)
+      : m_orbitals{n},
+        m_particles{m},
+        m_allow_double_occupancy{allow_double_occupancy},
+        m_basis_filter{adopt_own(filter)} {}
+
+  FermionicBasisGenerator(
+      std::size_t n, std::size_t m, bool allow_double_occupancy)
+      : FermionicBasisGenerator(
+            n, m, new BasisFilter(), allow_double_occupancy) {}
+
+  FermionicBasisGenerator(std::size_t n, std::size_t m, BasisFilter* filter)
+      : FermionicBasisGenerator(n, m, filter, true) {}
+
+  FermionicBasisGenerator(std::size_t n, std::size_t m)
+      : FermionicBasisGenerator(n, m, new BasisFilter(), true) {}
+
+  Iterator begin() const { return Iterator(this); }
+
+  std::default_sentinel_t end() const { return {}; }
+
+  std::size_t orbitals() const { return m_orbitals; }
+
+  std::size_t particles() const { return m_particles; }
+
+  // Number of states the generator yields, i.e. the size of the basis.
+  std::size_t count() const;
+
+ private:
+  std::size_t m_orbitals;
+  std::size_t m_particles;
+  bool m_allow_double_occupancy;
+  NonnullOwnPtr<BasisFilter> m_basis_filter;
+};
@@ -0,0 +1,4 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "CsrMatrix.h"
@@ -0,0 +1,125 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#include "Assert.h"
+#include "SparseMatrix.h"
+#include "TaskScheduler.h"
+
+// y = A x for any matrix type exposing the compressed sparse row arrays.
+template <typename Matrix, typename T>
+void csr_multiply(const Matrix& matrix, std::span<const T> x, std::span<T> y) {
+  LIBMB_ASSERT(x.size() == matrix.cols());
+  LIBMB_ASSERT(y.size() == matrix.rows());
+  const auto offsets = matrix.row_offsets();
+  const auto columns = matrix.columns();
+  const auto values = matrix.values();
+  TaskScheduler::current().parallel_for(
+      0, matrix.rows(), 1024, [&](std::size_t i) {
+        T sum{};
+        for (std::size_t k = offsets[i]; k < offsets[i + 1]; k++) {
+          sum += values[k] * x[columns[k]];
+        }
+        y[i] = sum;
+      });
+}
+
+// Compressed sparse row matrix. Columns are stored as 32-bit indices, which
+// is enough for any basis we can hold in memory and halves the index storage
+// of large Hamiltonians.
+template <typename T>
+class CsrMatrix {
+ public:
+  using Index = std::uint32_t;
+  using Offset = std::uint64_t;
+
+  CsrMatrix() = default;
+
+  CsrMatrix(
+      std::size_t rows, std::size_t cols, std::vector<Offset> row_offsets,
+      std::vector<Index> columns, std::vector<T> values)
+      : m_rows{rows},
+        m_cols{cols},
+        m_row_offsets{std::move(row_offsets)},
+        m_columns{std::move(columns)},
+        m_values{std::move(values)} {
+    LIBMB_ASSERT(m_row_offsets.size() == m_rows + 1);
+    LIBMB_ASSERT(m_columns.size() == m_values.size());
+  }
+
+  CsrMatrix(std::size_t rows, std::size_t cols, const SparseMatrix<T>& matrix)
+      : m_rows{rows}, m_cols{cols}, m_row_offsets(rows + 1, 0) {
+    std::vector<std::tuple<std::size_t, std::size_t, T>> entries;
+    entries.reserve(matrix.size());
+    for (const auto& [index, value] : matrix.elements()) {
+      LIBMB_ASSERT(index.i < rows && index.j < cols);
+      entries.emplace_back(index.i, index.j, value);
+    }
+    std::sort(
+        entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+          return std::tie(std::get<0>(a), std::get<1>(a)) <
+                 std::tie(std::get<0>(b), std::get<1>(b));
+        });
+
+    m_columns.reserve(entries.size());
+    m_values.reserve(entries.size());
+    for (const auto& [i, j, value] : entries) {
+      m_row_offsets[i + 1]++;
+      m_columns.push_back(static_cast<Index>(j));
+      m_values.push_back(value);
+    }
+    for (std::size_t i = 0; i < rows; i++) {
+      m_row_offsets[i + 1] += m_row_offsets[i];
+    }
+  }
+
+  std::size_t rows() const { return m_rows; }
+
+  std::size_t cols() const { return m_cols; }
+
+  std::size_t nonzeros() const { return m_values.size(); }
+
+  std::span<const Offset> row_offsets() const { return m_row_offsets; }
+
+  std::span<const Index> columns() const { return m_columns; }
+
+  std::span<const T> values() const { return m_values; }
+
+  T operator()(std::size_t i, std::size_t j) const {
+    auto begin =
+        m_columns.begin() + static_cast<std::ptrdiff_t>(m_row_offsets[i]);
+    auto end =
+        m_columns.begin() + static_cast<std::ptrdiff_t>(m_row_offsets[i + 1]);
+    auto it = std::lower_bound(begin, end, j);
+    if (it == end || *it != j) {
+      return T{};
+    }
+    return m_values[static_cast<std::size_t>(it - m_columns.begin())];
+  }
+
+  void multiply(std::span<const T> x, std::span<T> y) const {
+    csr_multiply(*this, x, y);
+  }
+
+  bool operator==(const CsrMatrix& other) const {
+    return m_rows == other.m_rows && m_cols == other.m_cols &&
+           m_row_offsets == other.m_row_offsets &&
+           m_columns == other.m_columns && m_values == other.m_values;
+  }
+
+  bool operator!=(const CsrMatrix& other) const { return !(*this == other); }
+
+ private:
+  std::size_t m_rows = 0;
+  std::size_t m_cols = 0;
+  std::vector<Offset> m_row_offsets = {0};
+  std::vector<Index> m_columns;
+  std::vector<T> m_values;
+};
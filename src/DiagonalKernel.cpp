@@ -0,0 +1,167 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "DiagonalKernel.h"
+
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define LIBMB_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+static void evaluate_scalar(
+    const DiagonalOperator& diagonal, const std::uint64_t* words,
+    double* energies, std::size_t n) {
+  for (std::size_t i = 0; i < n; i++) {
+    energies[i] = diagonal(words[i]);
+  }
+}
+
+#ifdef LIBMB_X86_KERNELS
+
+// AVX2 has no vector popcount: look up the counts of the two nibbles of
+// every byte and add the eight bytes of each word with a sum of absolute
+// differences against zero.
+__attribute__((target("avx2"))) static inline __m256i popcount_avx2(
+    __m256i x) {
+  const __m256i table = _mm256_setr_epi8(
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3,
+      1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+  const __m256i low = _mm256_and_si256(x, nibble);
+  const __m256i high = _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble);
+  const __m256i bytes = _mm256_add_epi8(
+      _mm256_shuffle_epi8(table, low), _mm256_shuffle_epi8(table, high));
+  return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+// Small non-negative integers to double without AVX-512: put them in the
+// mantissa of 2^52 and subtract it.
+__attribute__((target("avx2"))) static inline __m256d to_double_avx2(
+    __m256i x) {
+  const __m256i exponent = _mm256_set1_epi64x(0x4330000000000000);
+  const __m256d offset = _mm256_set1_pd(0x1p52);
+  return _mm256_sub_pd(
+      _mm256_castsi256_pd(_mm256_or_si256(x, exponent)), offset);
+}
+
+__attribute__((target("avx2"))) static void evaluate_avx2(
+    const DiagonalOperator& diagonal, const std::uint64_t* words,
+    double* energies, std::size_t n) {
+  const auto& groups = diagonal.groups();
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m256i word = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(words + i));
+    __m256d energy = _mm256_set1_pd(diagonal.constant());
+    for (const auto& group : groups) {
+      const __m256i shifted =
+          _mm256_srlv_epi64(word, _mm256_set1_epi64x(group.shift));
+      const __m256i bits = _mm256_and_si256(
+          _mm256_and_si256(word, shifted),
+          _mm256_set1_epi64x(static_cast<long long>(group.mask)));
+      const __m256d count = to_double_avx2(popcount_avx2(bits));
+      energy = _mm256_add_pd(
+          energy, _mm256_mul_pd(_mm256_set1_pd(group.coefficient), count));
+    }
+    _mm256_storeu_pd(energies + i, energy);
+  }
+  evaluate_scalar(diagonal, words + i, energies + i, n - i);
+}
+
+__attribute__((target("avx512f,avx512dq,avx512vpopcntdq"))) static void
+evaluate_avx512(
+    const DiagonalOperator& diagonal, const std::uint64_t* words,
+    double* energies, std::size_t n) {
+  const auto& groups = diagonal.groups();
+  // The last block is loaded and stored under a mask instead of falling
+  // back to scalar code.
+  for (std::size_t i = 0; i < n; i += 8) {
+    const std::size_t lanes = n - i < 8 ? n - i : 8;
+    const auto active = static_cast<__mmask8>((1u << lanes) - 1);
+    const __m512i word = _mm512_maskz_loadu_epi64(active, words + i);
+    __m512d energy = _mm512_set1_pd(diagonal.constant());
+    for (const auto& group : groups) {
+      // The unmasked shift starts from an undefined vector, which GCC
+      // reports as maybe uninitialized; all lanes are written either way.
+      const __m512i shifted = _mm512_maskz_srlv_epi64(
+          0xff, word, _mm512_set1_epi64(group.shift));
+      const __m512i bits = _mm512_and_si512(
+          _mm512_and_si512(word, shifted),
+          _mm512_set1_epi64(static_cast<long long>(group.mask)));
+      const __m512d count = _mm512_cvtepi64_pd(_mm512_popcnt_epi64(bits));
+      energy = _mm512_add_pd(
+          energy, _mm512_mul_pd(_mm512_set1_pd(group.coefficient), count));
+    }
+    _mm512_mask_storeu_pd(energies + i, active, energy);
+  }
+}
+
+#endif
+
+static SimdLevel detect_simd_level() {
+#ifdef LIBMB_X86_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") &&
+      __builtin_cpu_supports("avx512dq") &&
+      __builtin_cpu_supports("avx512vpopcntdq")) {
+    return SimdLevel::Avx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::Avx2;
+  }
+#endif
+  return SimdLevel::Scalar;
+}
+
+SimdLevel simd_level() {
+  static const SimdLevel level = detect_simd_level();
+  return level;
+}
+
+const char* simd_level_name(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::Scalar:
+      return "scalar";
+    case SimdLevel::Avx2:
+      return "avx2";
+    case SimdLevel::Avx512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
+void evaluate_diagonal(
+    const DiagonalOperator& diagonal, std::span<const std::uint64_t> words,
+    std::span<double> energies) {
+  evaluate_diagonal(diagonal, words, energies, simd_level());
+}
+
+void evaluate_diagonal(
+    const DiagonalOperator& diagonal, std::span<const std::uint64_t> words,
+    std::span<double> energies, SimdLevel level) {
+  // Checked in release builds too: running a kernel the CPU lacks would
+  // crash with an illegal instruction.
+  if (words.size() != energies.size()) {
+    throw std::invalid_argument(
+        "evaluate_diagonal: words and energies differ in size");
+  }
+  if (level > simd_level()) {
+    throw std::invalid_argument(
+        "evaluate_diagonal: the CPU does not support this SIMD level");
+  }
+  switch (level) {
+#ifdef LIBMB_X86_KERNELS
+    case SimdLevel::Avx512:
+      evaluate_avx512(diagonal, words.data(), energies.data(), words.size());
+      return;
+    case SimdLevel::Avx2:
+      evaluate_avx2(diagonal, words.data(), energies.data(), words.size());
+      return;
+#endif
+    default:
+      evaluate_scalar(diagonal, words.data(), energies.data(), words.size());
+      return;
+  }
+}
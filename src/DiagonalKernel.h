@@ -0,0 +1,37 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "DiagonalOperator.h"
+
+// Instruction sets for the batched evaluation of a DiagonalOperator, from
+// the portable one up.
+enum class SimdLevel {
+  Scalar,
+  // Four words at a time, popcount from a nibble lookup table.
+  Avx2,
+  // Eight words at a time with VPOPCNTQ.
+  Avx512,
+};
+
+// The best level the running CPU supports. Detected once.
+SimdLevel simd_level();
+
+const char* simd_level_name(SimdLevel level);
+
+// energies[i] = diagonal(words[i]) for a block of words, on the calling
+// thread, with the best supported level. This is the kernel behind
+// DiagonalOperator::evaluate() and the matrix-free HubbardEngine::apply().
+void evaluate_diagonal(
+    const DiagonalOperator& diagonal, std::span<const std::uint64_t> words,
+    std::span<double> energies);
+
+// Same with a given level. Throws std::invalid_argument if the CPU does not
+// support it, or if the spans differ in size.
+void evaluate_diagonal(
+    const DiagonalOperator& diagonal, std::span<const std::uint64_t> words,
+    std::span<double> energies, SimdLevel level);
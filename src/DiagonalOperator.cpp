@@ -0,0 +1,137 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "DiagonalOperator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "Assert.h"
+#include "Basis.h"
+#include "DiagonalKernel.h"
+#include "TaskScheduler.h"
+
+DiagonalOperator DiagonalOperator::split(
+    Expression& hamiltonian, std::size_t orbitals, OccupationLayout layout) {
+  DiagonalOperator result(orbitals, layout);
+  std::erase_if(hamiltonian.terms(), [&result](const auto& item) {
+    return result.add(item.first, item.second);
+  });
+  result.regroup();
+  return result;
+}
+
+bool DiagonalOperator::insert(
+    const std::vector<Operator>& operators, Term::CoeffType coeff) {
+  if (!add(operators, coeff)) {
+    return false;
+  }
+  regroup();
+  return true;
+}
+
+bool DiagonalOperator::add(
+    const std::vector<Operator>& operators, Term::CoeffType coeff) {
+  if (std::fpclassify(coeff.imag()) != FP_ZERO) {
+    return false;
+  }
+  if (operators.empty()) {
+    m_constant += coeff.real();
+    m_has_constant = true;
+    return true;
+  }
+  if (operators.size() != 2 && operators.size() != 4) {
+    return false;
+  }
+
+  // Every spin-orbital must be created once and annihilated once, to the
+  // right of its creation operator. The term is then a product of
+  // densities, up to the sign of bringing the pairs together.
+  std::uint64_t modes = 0;
+  for (std::size_t i = 0; i < operators.size(); i++) {
+    const Operator& op = operators[i];
+    if (!op.is_fermion() || op.orbital() >= m_orbitals) {
+      return false;
+    }
+    if (op.type() == Operator::Type::Annihilation) {
+      continue;
+    }
+    std::size_t annihilations = 0;
+    std::size_t creations = 0;
+    for (std::size_t j = 0; j < operators.size(); j++) {
+      if (operators[j].orbital() != op.orbital() ||
+          operators[j].spin() != op.spin()) {
+        continue;
+      }
+      if (operators[j].type() == Operator::Type::Creation) {
+        creations++;
+      } else if (j > i) {
+        annihilations++;
+      } else {
+        return false;
+      }
+    }
+    if (creations != 1 || annihilations != 1) {
+      return false;
+    }
+    modes |= std::uint64_t{1}
+             << (2 * op.orbital() + static_cast<std::size_t>(op.spin()));
+  }
+  if (static_cast<std::size_t>(std::popcount(modes)) * 2 != operators.size()) {
+    return false;
+  }
+
+  auto result = apply_operators(operators, modes);
+  LIBMB_ASSERT(result.has_value() && result->first == modes);
+  const double coefficient = result->second * coeff.real();
+
+  std::vector<std::size_t> bits;
+  for (const Operator& op : operators) {
+    if (op.type() == Operator::Type::Creation) {
+      bits.push_back(bit(op));
+    }
+  }
+  std::sort(bits.begin(), bits.end());
+  const auto shift = static_cast<unsigned>(bits.back() - bits.front());
+  m_coefficients[{shift, bits.front()}] += coefficient;
+  return true;
+}
+
+void DiagonalOperator::regroup() {
+  std::map<std::pair<double, unsigned>, std::uint64_t> masks;
+  for (const auto& [key, coefficient] : m_coefficients) {
+    if (std::fpclassify(coefficient) != FP_ZERO) {
+      masks[{coefficient, key.first}] |= std::uint64_t{1} << key.second;
+    }
+  }
+
+  m_groups.clear();
+  for (const auto& [key, mask] : masks) {
+    m_groups.push_back({key.first, key.second, mask});
+  }
+}
+
+std::size_t DiagonalOperator::bit(const Operator& op) const {
+  const auto spin = static_cast<std::size_t>(op.spin());
+  return m_layout == OccupationLayout::Interleaved
+             ? 2 * op.orbital() + spin
+             : spin * m_orbitals + op.orbital();
+}
+
+void DiagonalOperator::evaluate(
+    std::span<const std::uint64_t> words, std::span<double> energies) const {
+  if (words.size() != energies.size()) {
+    throw std::invalid_argument(
+        "DiagonalOperator: words and energies differ in size");
+  }
+  // Blocks large enough to amortize the dispatch, small enough to balance.
+  static constexpr std::size_t block = 4096;
+  const std::size_t blocks = (words.size() + block - 1) / block;
+  TaskScheduler::current().parallel_for(0, blocks, 1, [&](std::size_t b) {
+    const std::size_t first = b * block;
+    const std::size_t count = std::min(block, words.size() - first);
+    evaluate_diagonal(
+        *this, words.subspan(first, count), energies.subspan(first, count));
+  });
+}
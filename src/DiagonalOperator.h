@@ -0,0 +1,94 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Expression.h"
+
+// How the spin-orbitals of a fermionic state are laid out in a 64-bit word.
+enum class OccupationLayout {
+  // Bit 2 * orbital + spin, as in occupation_bits().
+  Interleaved,
+  // Bit spin * orbitals + orbital: the up electrons in the low bits, the
+  // down electrons above them, as in HubbardEngine.
+  SpinBlocked,
+};
+
+// Sum of density and density-density terms, which only depend on the
+// occupations. Instead of multiplying and normal ordering them for every
+// state, the terms are grouped by coefficient and by the distance d between
+// the two bits they test, and a state s is evaluated as
+//
+//   sum  coefficient * popcount(s & (s >> d) & mask)
+//
+// with one AND and popcount per group (d = 0 for densities).
+class DiagonalOperator {
+ public:
+  struct Group {
+    double coefficient;
+    unsigned shift;
+    std::uint64_t mask;
+  };
+
+  DiagonalOperator(
+      std::size_t orbitals,
+      OccupationLayout layout = OccupationLayout::Interleaved)
+      : m_orbitals{orbitals}, m_layout{layout} {}
+
+  // Moves the terms of `hamiltonian` that a DiagonalOperator can evaluate
+  // into one, leaving the others.
+  static DiagonalOperator split(
+      Expression& hamiltonian, std::size_t orbitals,
+      OccupationLayout layout = OccupationLayout::Interleaved);
+
+  // Adds a constant, density or density-density term with a real
+  // coefficient. Returns false, and leaves the operator unchanged, for
+  // anything else.
+  bool insert(const std::vector<Operator>& operators, Term::CoeffType coeff);
+
+  bool empty() const { return m_groups.empty() && !m_has_constant; }
+
+  const std::vector<Group>& groups() const { return m_groups; }
+
+  double constant() const { return m_constant; }
+
+  OccupationLayout layout() const { return m_layout; }
+
+  double operator()(std::uint64_t word) const {
+    double energy = m_constant;
+    for (const Group& group : m_groups) {
+      energy += group.coefficient *
+                std::popcount(word & (word >> group.shift) & group.mask);
+    }
+    return energy;
+  }
+
+  // energies[i] = (*this)(words[i]), in parallel and with the SIMD kernel
+  // of DiagonalKernel.h. Throws std::invalid_argument if the spans differ
+  // in size.
+  void evaluate(
+      std::span<const std::uint64_t> words, std::span<double> energies) const;
+
+ private:
+  bool add(const std::vector<Operator>& operators, Term::CoeffType coeff);
+
+  void regroup();
+
+  std::size_t bit(const Operator& op) const;
+
+  std::size_t m_orbitals;
+  OccupationLayout m_layout;
+  // Coefficient of every pair (d, lower bit), from which the groups are
+  // rebuilt.
+  std::map<std::pair<unsigned, std::size_t>, double> m_coefficients;
+  std::vector<Group> m_groups;
+  double m_constant = 0.0;
+  bool m_has_constant = false;
+};
@@ -0,0 +1,230 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "DiskCache.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+static constexpr std::uint32_t cache_version = 1;
+static constexpr std::uint32_t byte_order_mark = 0x01020304;
+static constexpr std::array<char, 8> basis_magic = {'L', 'M', 'B', 'B',
+                                                    'A', 'S', 'I', 'S'};
+static constexpr std::array<char, 8> matrix_magic = {'L', 'M', 'B', 'C',
+                                                     'S', 'R', 'M', 'T'};
+
+struct BasisFileHeader {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint64_t orbitals;
+  std::uint64_t particles;
+  std::uint64_t size;
+  std::uint64_t sorted;
+};
+
+struct MatrixFileHeader {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint64_t value_size;
+  std::uint64_t rows;
+  std::uint64_t cols;
+  std::uint64_t nonzeros;
+};
+
+static constexpr std::size_t align8(std::size_t n) {
+  return (n + 7) & ~std::size_t{7};
+}
+
+template <typename T>
+static void write_span(std::ofstream& out, std::span<const T> data) {
+  out.write(
+      reinterpret_cast<const char*>(data.data()),
+      static_cast<std::streamsize>(data.size_bytes()));
+}
+
+static void write_padding(std::ofstream& out, std::size_t bytes) {
+  static constexpr std::array<char, 8> zeros{};
+  out.write(zeros.data(), static_cast<std::streamsize>(align8(bytes) - bytes));
+}
+
+template <typename T>
+static std::span<const T> read_span(
+    const MappedFile& file, std::size_t offset, std::size_t count) {
+  return {reinterpret_cast<const T*>(file.data() + offset), count};
+}
+
+// Row offsets that start at 0, never decrease and end at `nonzeros`, so
+// that every row is a valid range of the columns and values.
+static bool valid_offsets(
+    std::span<const std::uint64_t> offsets, std::uint64_t nonzeros) {
+  return offsets.front() == 0 && offsets.back() == nonzeros &&
+         std::is_sorted(offsets.begin(), offsets.end());
+}
+
+bool save_basis(const Basis& basis, const std::string& path) {
+  std::vector<std::uint64_t> words;
+  words.reserve(basis.size());
+  for (const BasisElement& element : basis.elements()) {
+    for (const Operator& op : element) {
+      if (!op.is_fermion() || op.type() != Operator::Type::Creation) {
+        return false;
+      }
+    }
+    words.push_back(occupation_bits(element));
+  }
+
+  const bool sorted =
+      std::is_sorted(words.begin(), words.end(), canonical_less);
+
+  BasisFileHeader header{
+      basis_magic, cache_version, byte_order_mark, basis.orbitals(),
+      basis.particles(), words.size(), sorted ? 1u : 0u};
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  write_span<std::uint64_t>(out, words);
+
+  if (!sorted) {
+    std::vector<std::uint64_t> order(words.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](auto a, auto b) {
+      return canonical_less(words[a], words[b]);
+    });
+    write_span<std::uint64_t>(out, order);
+  }
+
+  return out.good();
+}
+
+std::optional<MappedBasis> MappedBasis::open(const std::string& path) {
+  auto file = MappedFile::open(path);
+  if (!file.has_value() || file->size() < sizeof(BasisFileHeader)) {
+    return std::nullopt;
+  }
+
+  BasisFileHeader header;
+  std::memcpy(&header, file->data(), sizeof(header));
+  if (header.magic != basis_magic || header.version != cache_version ||
+      header.byte_order != byte_order_mark) {
+    return std::nullopt;
+  }
+
+  // Bounded by the file size first, so that the sizes cannot overflow.
+  const std::size_t count = header.size;
+  if (count > file->size() / sizeof(std::uint64_t)) {
+    return std::nullopt;
+  }
+  const std::size_t words_bytes = count * sizeof(std::uint64_t);
+  const std::size_t expected_size =
+      sizeof(header) + (header.sorted ? 1u : 2u) * words_bytes;
+  if (file->size() != expected_size) {
+    return std::nullopt;
+  }
+
+  MappedBasis result(std::move(*file));
+  result.m_orbitals = header.orbitals;
+  result.m_particles = header.particles;
+  result.m_words =
+      read_span<std::uint64_t>(result.m_file, sizeof(header), count);
+  if (!header.sorted) {
+    result.m_order = read_span<std::uint64_t>(
+        result.m_file, sizeof(header) + words_bytes, count);
+    // find() indexes the words with the permutation.
+    if (std::any_of(
+            result.m_order.begin(), result.m_order.end(),
+            [count](std::uint64_t i) { return i >= count; })) {
+      return std::nullopt;
+    }
+  }
+  return result;
+}
+
+std::optional<std::size_t> MappedBasis::find(std::uint64_t word) const {
+  if (m_order.empty()) {
+    auto it =
+        std::lower_bound(m_words.begin(), m_words.end(), word, canonical_less);
+    if (it == m_words.end() || *it != word) {
+      return std::nullopt;
+    }
+    return static_cast<std::size_t>(it - m_words.begin());
+  }
+
+  auto it = std::lower_bound(
+      m_order.begin(), m_order.end(), word,
+      [this](std::uint64_t i, std::uint64_t w) {
+        return canonical_less(m_words[i], w);
+      });
+  if (it == m_order.end() || m_words[*it] != word) {
+    return std::nullopt;
+  }
+  return *it;
+}
+
+bool write_matrix_file(
+    const std::string& path, const MatrixFileView& matrix,
+    std::size_t value_size) {
+  MatrixFileHeader header{
+      matrix_magic, cache_version, byte_order_mark,      value_size,
+      matrix.rows,  matrix.cols,   matrix.columns.size()};
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  write_span(out, matrix.row_offsets);
+  write_span(out, matrix.columns);
+  write_padding(out, matrix.columns.size_bytes());
+  out.write(
+      reinterpret_cast<const char*>(matrix.values),
+      static_cast<std::streamsize>(matrix.columns.size() * value_size));
+  return out.good();
+}
+
+std::optional<std::pair<MappedFile, MatrixFileView>> read_matrix_file(
+    const std::string& path, std::size_t value_size) {
+  auto file = MappedFile::open(path);
+  if (!file.has_value() || file->size() < sizeof(MatrixFileHeader)) {
+    return std::nullopt;
+  }
+
+  MatrixFileHeader header;
+  std::memcpy(&header, file->data(), sizeof(header));
+  if (header.magic != matrix_magic || header.version != cache_version ||
+      header.byte_order != byte_order_mark ||
+      header.value_size != value_size) {
+    return std::nullopt;
+  }
+
+  // Bounded by the file size first, so that the sizes cannot overflow.
+  const std::size_t largest = std::max(value_size, sizeof(std::uint32_t));
+  if (header.rows >= file->size() / sizeof(std::uint64_t) ||
+      header.nonzeros > file->size() / largest) {
+    return std::nullopt;
+  }
+  const std::size_t offsets_at = sizeof(header);
+  const std::size_t columns_at =
+      offsets_at + (header.rows + 1) * sizeof(std::uint64_t);
+  const std::size_t values_at =
+      columns_at + align8(header.nonzeros * sizeof(std::uint32_t));
+  if (file->size() != values_at + header.nonzeros * value_size) {
+    return std::nullopt;
+  }
+
+  MatrixFileView view{
+      header.rows, header.cols,
+      read_span<std::uint64_t>(*file, offsets_at, header.rows + 1),
+      read_span<std::uint32_t>(*file, columns_at, header.nonzeros),
+      file->data() + values_at};
+  // Products index the rows with the offsets and the vector with the
+  // columns, so both are checked once here.
+  if (!valid_offsets(view.row_offsets, header.nonzeros) ||
+      std::any_of(
+          view.columns.begin(), view.columns.end(),
+          [&header](std::uint32_t j) { return j >= header.cols; })) {
+    return std::nullopt;
+  }
+  return std::make_pair(std::move(*file), view);
+}
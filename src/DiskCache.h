@@ -0,0 +1,131 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
+#include "Basis.h"
+#include "CsrMatrix.h"
+#include "MappedFile.h"
+
+// Binary caches for fermionic bases and assembled matrices. The files are
+// laid out so that they can be memory-mapped and used in place: an expensive
+// basis or Hamiltonian is built once and then shared, without copies, by all
+// processes that open it. Data is stored in native byte order; files written
+// on a machine with a different byte order are rejected when opened, and so
+// are files whose indices point outside of the data, which opening checks
+// in one pass over the indices.
+
+// Writes the occupation words of a fermionic basis, in index order. Returns
+// false if the basis is not fermionic or the file cannot be written.
+bool save_basis(const Basis& basis, const std::string& path);
+
+class MappedBasis {
+ public:
+  static std::optional<MappedBasis> open(const std::string& path);
+
+  std::size_t orbitals() const { return m_orbitals; }
+
+  std::size_t particles() const { return m_particles; }
+
+  std::size_t size() const { return m_words.size(); }
+
+  std::span<const std::uint64_t> words() const { return m_words; }
+
+  std::uint64_t word(std::size_t i) const { return m_words[i]; }
+
+  BasisElement element(std::size_t i) const {
+    return element_from_occupation_bits(m_words[i]);
+  }
+
+  bool contains(const BasisElement& element) const {
+    return find(occupation_bits(element)).has_value();
+  }
+
+  std::size_t index(const BasisElement& element) const {
+    auto result = find(occupation_bits(element));
+    LIBMB_ASSERT(result.has_value());
+    return *result;
+  }
+
+  std::optional<std::size_t> find(std::uint64_t word) const;
+
+ private:
+  explicit MappedBasis(MappedFile file) : m_file(std::move(file)) {}
+
+  MappedFile m_file;
+  std::size_t m_orbitals = 0;
+  std::size_t m_particles = 0;
+  std::span<const std::uint64_t> m_words;
+  // Permutation that sorts the words, only stored when the basis is not in
+  // canonical order. Lookups are binary searches in either case.
+  std::span<const std::uint64_t> m_order;
+};
+
+struct MatrixFileView {
+  std::size_t rows;
+  std::size_t cols;
+  std::span<const std::uint64_t> row_offsets;
+  std::span<const std::uint32_t> columns;
+  const std::byte* values;
+};
+
+bool write_matrix_file(
+    const std::string& path, const MatrixFileView& matrix,
+    std::size_t value_size);
+
+std::optional<std::pair<MappedFile, MatrixFileView>> read_matrix_file(
+    const std::string& path, std::size_t value_size);
+
+template <typename T>
+bool save_matrix(const CsrMatrix<T>& matrix, const std::string& path) {
+  MatrixFileView view{
+      matrix.rows(), matrix.cols(), matrix.row_offsets(), matrix.columns(),
+      reinterpret_cast<const std::byte*>(matrix.values().data())};
+  return write_matrix_file(path, view, sizeof(T));
+}
+
+// A CSR matrix backed directly by a memory-mapped cache file.
+template <typename T>
+class MappedCsrMatrix {
+ public:
+  using Index = std::uint32_t;
+  using Offset = std::uint64_t;
+
+  static std::optional<MappedCsrMatrix> open(const std::string& path) {
+    auto file = read_matrix_file(path, sizeof(T));
+    if (!file.has_value()) {
+      return std::nullopt;
+    }
+    return MappedCsrMatrix(std::move(file->first), file->second);
+  }
+
+  std::size_t rows() const { return m_view.rows; }
+
+  std::size_t cols() const { return m_view.cols; }
+
+  std::size_t nonzeros() const { return m_view.columns.size(); }
+
+  std::span<const Offset> row_offsets() const { return m_view.row_offsets; }
+
+  std::span<const Index> columns() const { return m_view.columns; }
+
+  std::span<const T> values() const {
+    return {reinterpret_cast<const T*>(m_view.values), nonzeros()};
+  }
+
+  void multiply(std::span<const T> x, std::span<T> y) const {
+    csr_multiply(*this, x, y);
+  }
+
+ private:
+  MappedCsrMatrix(MappedFile file, MatrixFileView view)
+      : m_file(std::move(file)), m_view(view) {}
+
+  MappedFile m_file;
+  MatrixFileView m_view;
+};
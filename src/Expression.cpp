@@ -3,9 +3,13 @@
 
 #include "Expression.h"
 
+#include <algorithm>
 #include <iostream>
+#include <numeric>
 #include <ostream>
 
+#include "TaskScheduler.h"
+
 std::ostream& operator<<(std::ostream& os, const Expression& e) {
   for (const auto& [operators, coeff] : e.terms()) {
     os << coeff << "  {";
@@ -17,6 +21,144 @@ std::ostream& operator<<(std::ostream& os, const Expression& e) {
   return os;
 }
 
+Expression Expression::product(
+    const Expression& other, TaskScheduler& scheduler) const {
+  Expression empty;
+  empty.m_tolerance = std::max(m_tolerance, other.m_tolerance);
+  const std::size_t chunks = product_chunks(size() * other.size(), scheduler);
+  if (chunks == 1) {
+    Expression result = empty;
+    for (const auto& [operators_a, coefficient_a] : terms()) {
+      for (const auto& [operators_b, coefficient_b] : other.terms()) {
+        result.add_product(
+            coefficient_a * coefficient_b, operators_a, operators_b);
+      }
+    }
+    return result;
+  }
+
+  std::vector<const ExpressionMap::value_type*> outer;
+  outer.reserve(size());
+  for (const auto& term : m_terms) {
+    outer.push_back(&term);
+  }
+  std::vector<Expression> parts(chunks, empty);
+  scheduler.parallel_for(0, chunks, 1, [&](std::size_t k) {
+    const std::size_t first = k * outer.size() / chunks;
+    const std::size_t last = (k + 1) * outer.size() / chunks;
+    for (std::size_t i = first; i < last; i++) {
+      const auto& [operators_a, coefficient_a] = *outer[i];
+      for (const auto& [operators_b, coefficient_b] : other.terms()) {
+        parts[k].add_product(
+            coefficient_a * coefficient_b, operators_a, operators_b);
+      }
+    }
+  });
+  return sum(std::move(parts), scheduler);
+}
+
+Expression Expression::product(const Expression& other) const {
+  return product(other, TaskScheduler::current());
+}
+
+std::size_t Expression::product_chunks(
+    std::size_t pairs, const TaskScheduler& scheduler) {
+  // The parts are merged afterwards, which is only worth it when they run
+  // at the same time.
+  if (pairs < parallel_product_pairs) {
+    return 1;
+  }
+  return scheduler.concurrency();
+}
+
+Expression sum(std::vector<Expression> expressions, TaskScheduler& scheduler) {
+  double tolerance = 0.0;
+  double discarded = 0.0;
+  for (const Expression& expression : expressions) {
+    tolerance = std::max(tolerance, expression.m_tolerance);
+    discarded += expression.m_discarded;
+  }
+  std::erase_if(expressions, [](const Expression& e) { return e.size() == 0; });
+  if (expressions.size() <= 1) {
+    Expression result =
+        expressions.empty() ? Expression() : std::move(expressions.front());
+    result.m_discarded = discarded;
+    result.set_tolerance(tolerance);
+    return result;
+  }
+
+  using ExpressionMap = Expression::ExpressionMap;
+  const std::size_t parts = expressions.size();
+  const std::size_t shards = scheduler.concurrency();
+  const std::hash<std::vector<Operator>> hash;
+
+  // Every part is split into shards, moving its nodes...
+  std::vector<std::vector<ExpressionMap>> split(
+      parts, std::vector<ExpressionMap>(shards));
+  scheduler.parallel_for(0, parts, 1, [&](std::size_t p) {
+    auto& terms = expressions[p].terms();
+    while (!terms.empty()) {
+      auto node = terms.extract(terms.begin());
+      split[p][hash(node.key()) % shards].insert(std::move(node));
+    }
+  });
+
+  // ...the shards are summed, each on its own...
+  std::vector<ExpressionMap> merged(shards);
+  std::vector<double> shard_discarded(shards, 0.0);
+  scheduler.parallel_for(0, shards, 1, [&](std::size_t s) {
+    ExpressionMap& shard = merged[s];
+    for (std::size_t p = 0; p < parts; p++) {
+      ExpressionMap& terms = split[p][s];
+      if (shard.empty()) {
+        shard = std::move(terms);
+        continue;
+      }
+      while (!terms.empty()) {
+        auto node = terms.extract(terms.begin());
+        auto it = shard.find(node.key());
+        if (it != shard.end()) {
+          it->second += node.mapped();
+        } else {
+          shard.insert(std::move(node));
+        }
+      }
+    }
+    if (tolerance > 0.0) {
+      std::erase_if(shard, [&](const auto& term) {
+        const double weight = std::abs(term.second);
+        if (weight < tolerance) {
+          shard_discarded[s] += weight;
+          return true;
+        }
+        return false;
+      });
+    }
+  });
+
+  // ...and put together, which only moves nodes since no key is in two
+  // shards.
+  std::size_t total = 0;
+  for (const ExpressionMap& shard : merged) {
+    total += shard.size();
+  }
+  Expression result;
+  result.m_terms.reserve(total);
+  for (ExpressionMap& shard : merged) {
+    while (!shard.empty()) {
+      result.m_terms.insert(shard.extract(shard.begin()));
+    }
+  }
+  result.m_tolerance = tolerance;
+  result.m_discarded = std::accumulate(
+      shard_discarded.begin(), shard_discarded.end(), discarded);
+  return result;
+}
+
+Expression sum(std::vector<Expression> expressions) {
+  return sum(std::move(expressions), TaskScheduler::current());
+}
+
 Expression add(const Term& a, const Term& b) {
   Expression result;
   result.insert(a);
@@ -4,11 +4,14 @@
 #pragma once
 
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "Operator.h"
 #include "Term.h"
 
+class TaskScheduler;
+
 class Expression {
  public:
   using ExpressionMap =
@@ -27,32 +30,93 @@ class Expression {
   }
 
   void insert(const Term& term) {
-    m_terms[term.operators()] += term.coefficient();
+    accumulate(term.operators(), term.coefficient());
+  }
+
+  void insert(Term&& term) {
+    accumulate(std::move(term.operators()), term.coefficient());
   }
 
   void insert(const Expression& other) {
+    m_discarded += other.m_discarded;
     for (const auto& [operators, coefficient] : other.terms()) {
-      m_terms[operators] += coefficient;
+      accumulate(operators, coefficient);
+    }
+  }
+
+  // Moves the operator strings of `other` instead of copying them.
+  void insert(Expression&& other) {
+    m_discarded += other.m_discarded;
+    if (m_terms.empty() && other.m_tolerance >= m_tolerance) {
+      m_terms = std::move(other.m_terms);
+      return;
+    }
+    while (!other.m_terms.empty()) {
+      auto node = other.m_terms.extract(other.m_terms.begin());
+      accumulate(std::move(node.key()), node.mapped());
     }
   }
 
-  void insert(double coefficient) { m_terms[{}] += coefficient; }
+  void insert(double coefficient) {
+    accumulate(std::vector<Operator>{}, coefficient);
+  }
 
   Expression& operator+=(const Expression& other) {
     insert(other);
     return *this;
   }
 
+  Expression& operator+=(Expression&& other) {
+    insert(std::move(other));
+    return *this;
+  }
+
   Expression& operator+=(const Term& other) {
     insert(other);
     return *this;
   }
 
+  Expression& operator+=(Term&& other) {
+    insert(std::move(other));
+    return *this;
+  }
+
   Expression& operator+=(double other) {
     insert(other);
     return *this;
   }
 
+  Expression& operator*=(Term::CoeffType coefficient) {
+    for (auto& [operators, value] : m_terms) {
+      value *= coefficient;
+    }
+    m_discarded *= std::abs(coefficient);
+    if (m_tolerance > 0.0) {
+      truncate();
+    }
+    return *this;
+  }
+
+  // Terms whose coefficients fall below `tolerance` in absolute value, as
+  // they are inserted or accumulated, are dropped and their weight added to
+  // discarded(). This bounds the size of nested commutators, where most
+  // terms cancel to rounding errors or are negligible. The tolerance is
+  // passed on to products, commutators and normal orderings. The default
+  // of zero keeps every term, including those that cancel exactly.
+  //
+  // Setting a tolerance drops the terms already below it.
+  void set_tolerance(double tolerance) {
+    m_tolerance = tolerance;
+    truncate();
+  }
+
+  double tolerance() const { return m_tolerance; }
+
+  // Sum of the absolute values of the coefficients dropped while building
+  // this expression, including those dropped from the terms of sums. It is
+  // scaled along with the terms, so it stays in the units of the terms.
+  double discarded() const { return m_discarded; }
+
   std::size_t size() const { return m_terms.size(); }
 
   const ExpressionMap& terms() const { return m_terms; }
@@ -65,61 +129,84 @@ class Expression {
 
   bool operator!=(const Expression& other) const { return !(*this == other); }
 
-  Expression add(const Expression& other) const {
-    Expression result(*this);
-    for (const auto& [operators, coefficient] : other.terms()) {
-      result.insert(Term(coefficient, operators));
-    }
-    return result;
+  // As for Term, the && overloads reuse the map of a temporary.
+  Expression add(const Expression& other) const& {
+    return Expression(*this).add(other);
   }
 
-  Expression add(const Term& other) const {
-    Expression result(*this);
-    result.insert(other);
-    return result;
+  Expression add(const Expression& other) && {
+    insert(other);
+    return std::move(*this);
+  }
+
+  Expression add(const Term& other) const& {
+    return Expression(*this).add(other);
+  }
+
+  Expression add(const Term& other) && {
+    insert(other);
+    return std::move(*this);
   }
 
   friend Expression operator+(const Expression& lhs, const Expression& rhs) {
     return lhs.add(rhs);
   }
 
+  friend Expression operator+(Expression&& lhs, const Expression& rhs) {
+    return std::move(lhs).add(rhs);
+  }
+
   friend Expression operator+(const Expression& lhs, const Term& rhs) {
     return lhs.add(rhs);
   }
 
-  Expression product(const Expression& other) const {
-    Expression result;
-    for (const auto& [operators_a, coefficient_a] : terms()) {
-      for (const auto& [operators_b, coefficient_b] : other.terms()) {
-        result.insert(Term(coefficient_a, operators_a)
-                          .product(Term(coefficient_b, operators_b)));
-      }
-    }
-    return result;
+  friend Expression operator+(Expression&& lhs, const Term& rhs) {
+    return std::move(lhs).add(rhs);
   }
 
+  // The product keeps the larger tolerance of the two, and starts with
+  // nothing discarded. Large products are split over the threads of
+  // `scheduler` by the terms of *this, and the partial results merged with
+  // sum().
+  Expression product(
+      const Expression& other, TaskScheduler& scheduler) const;
+
+  // The product on TaskScheduler::current().
+  Expression product(const Expression& other) const;
+
+  // Below this many pairs of terms, products run on the calling thread.
+  static constexpr std::size_t parallel_product_pairs = 1 << 16;
+
+  // Number of parts that a product of `pairs` pairs of terms is split into
+  // on `scheduler`.
+  static std::size_t product_chunks(
+      std::size_t pairs, const TaskScheduler& scheduler);
+
   Expression product(const Term& other) const {
-    Expression result;
+    Expression result = empty_like();
     for (const auto& [operators_a, coefficient_a] : terms()) {
-      result.insert(Term(coefficient_a, operators_a).product(other));
+      result.add_product(
+          coefficient_a * other.coefficient(), operators_a,
+          other.operators());
     }
     return result;
   }
 
   Expression product(const std::vector<Operator>& other) const {
-    Expression result;
+    Expression result = empty_like();
     for (const auto& [operators_a, coefficient_a] : terms()) {
-      result.insert(Term(coefficient_a, operators_a).product(other));
+      result.add_product(coefficient_a, operators_a, other);
     }
     return result;
   }
 
-  Expression product(double coefficient) const {
-    Expression result;
-    for (const auto& [operators_a, coefficient_a] : terms()) {
-      result.insert(Term(coefficient * coefficient_a, operators_a));
-    }
-    return result;
+  Expression product(double coefficient) const& {
+    return Expression(*this).product(coefficient);
+  }
+
+  Expression product(double coefficient) && {
+    *this *= coefficient;
+    return std::move(*this);
   }
 
   friend Expression operator*(const Expression& lhs, const Expression& rhs) {
@@ -139,30 +226,95 @@ class Expression {
     return other.product(coefficient);
   }
 
-  Expression adjoint() const {
-    Expression result;
-    for (const auto& [operators, coefficient] : terms()) {
-      result.insert(Term(coefficient, operators).adjoint());
-    }
-    return result;
+  friend Expression operator*(double coefficient, Expression&& other) {
+    return std::move(other).product(coefficient);
   }
 
-  Expression negate() const {
-    Expression result;
-    for (const auto& [operators, coefficient] : terms()) {
-      result.insert(Term(-coefficient, operators));
+  Expression adjoint() const& { return Expression(*this).adjoint(); }
+
+  // The adjoint changes the keys, so the terms are moved into a new map one
+  // node at a time.
+  Expression adjoint() && {
+    Expression result = empty_like();
+    result.m_discarded = m_discarded;
+    result.m_terms.reserve(m_terms.size());
+    while (!m_terms.empty()) {
+      auto node = m_terms.extract(m_terms.begin());
+      Term term(node.mapped(), std::move(node.key()));
+      result.insert(std::move(term).adjoint());
     }
     return result;
   }
 
+  Expression negate() const& { return Expression(*this).negate(); }
+
+  Expression negate() && {
+    *this *= -1.0;
+    return std::move(*this);
+  }
+
   friend std::ostream& operator<<(std::ostream& os, const Expression& e);
 
+  friend Expression sum(
+      std::vector<Expression> expressions, TaskScheduler& scheduler);
+
+  friend class NormalOrderer;
+
  private:
+  // No terms, with the tolerance of *this.
+  Expression empty_like() const {
+    Expression result;
+    result.m_tolerance = m_tolerance;
+    return result;
+  }
+
+  template <typename Key>
+  void accumulate(Key&& operators, Term::CoeffType coefficient) {
+    auto it = m_terms.try_emplace(std::forward<Key>(operators)).first;
+    it->second += coefficient;
+    if (m_tolerance > 0.0 && std::abs(it->second) < m_tolerance) {
+      m_discarded += std::abs(it->second);
+      m_terms.erase(it);
+    }
+  }
+
+  // Drops the terms below the tolerance.
+  void truncate() {
+    std::erase_if(m_terms, [this](const auto& term) {
+      const double weight = std::abs(term.second);
+      if (weight < m_tolerance) {
+        m_discarded += weight;
+        return true;
+      }
+      return false;
+    });
+  }
+
+  // Adds coefficient * a b, building the key of the product only once.
+  void add_product(
+      Term::CoeffType coefficient, const std::vector<Operator>& a,
+      const std::vector<Operator>& b) {
+    std::vector<Operator> operators;
+    operators.reserve(a.size() + b.size());
+    operators.assign(a.begin(), a.end());
+    operators.insert(operators.end(), b.begin(), b.end());
+    accumulate(std::move(operators), coefficient);
+  }
+
   ExpressionMap m_terms;
+  double m_tolerance = 0.0;
+  double m_discarded = 0.0;
 };
 
 Expression add(const Term& a, const Term& b);
 
+// The sum of many expressions. The terms are split into shards by the hash
+// of their operators, and the shards summed in parallel on `scheduler`.
+Expression sum(std::vector<Expression> expressions, TaskScheduler& scheduler);
+
+// The sum on TaskScheduler::current().
+Expression sum(std::vector<Expression> expressions);
+
 template <Operator::Statistics S>
 Expression hopping(
     double t, Operator::Spin spin, std::size_t i, std::size_t j) {
@@ -0,0 +1,266 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "ExpressionFile.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+static_assert(sizeof(Operator) == 1);
+static_assert(sizeof(Term::CoeffType) == 2 * sizeof(double));
+
+static constexpr std::uint32_t expression_version = 1;
+static constexpr std::uint32_t byte_order_mark = 0x01020304;
+static constexpr std::array<char, 8> expression_magic = {'L', 'M', 'B', 'E',
+                                                         'X', 'P', 'R', 'S'};
+
+struct ExpressionFileHeader {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint64_t terms;
+  std::uint64_t operators;
+};
+
+static bool operators_less(
+    std::span<const Operator> a, std::span<const Operator> b) {
+  return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+static bool valid_header(const ExpressionFileHeader& header) {
+  return header.magic == expression_magic &&
+         header.version == expression_version &&
+         header.byte_order == byte_order_mark;
+}
+
+// Bytes after the header, and where the offsets and operators start.
+static std::size_t offsets_at(const ExpressionFileHeader& header) {
+  return sizeof(header) + header.terms * sizeof(Term::CoeffType);
+}
+
+static std::size_t operators_at(const ExpressionFileHeader& header) {
+  return offsets_at(header) + (header.terms + 1) * sizeof(std::uint64_t);
+}
+
+// Whether a file of `size` bytes holds exactly the arrays of `header`. The
+// counts are bounded by the size before they are multiplied, so that a
+// corrupt header cannot overflow the offsets above.
+static bool matches_size(const ExpressionFileHeader& header, std::size_t size) {
+  constexpr std::size_t term_bytes =
+      sizeof(Term::CoeffType) + sizeof(std::uint64_t);
+  if (size < sizeof(header) + sizeof(std::uint64_t)) {
+    return false;
+  }
+  const std::size_t bytes = size - sizeof(header) - sizeof(std::uint64_t);
+  return header.terms <= bytes / term_bytes &&
+         header.operators == bytes - header.terms * term_bytes;
+}
+
+static bool valid_offsets(
+    std::span<const std::uint64_t> offsets, std::uint64_t operators) {
+  return offsets.front() == 0 && offsets.back() == operators &&
+         std::is_sorted(offsets.begin(), offsets.end());
+}
+
+// Whether the strings that `offsets` cut out of `operators` strictly
+// increase, i.e. are sorted and hold no term twice, as find() requires.
+static bool strictly_increasing(
+    std::span<const std::uint64_t> offsets,
+    std::span<const Operator> operators) {
+  for (std::size_t i = 1; i + 1 < offsets.size(); i++) {
+    if (!operators_less(
+            operators.subspan(offsets[i - 1], offsets[i] - offsets[i - 1]),
+            operators.subspan(offsets[i], offsets[i + 1] - offsets[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+static void write_span(std::ostream& out, std::span<const T> data) {
+  out.write(
+      reinterpret_cast<const char*>(data.data()),
+      static_cast<std::streamsize>(data.size_bytes()));
+}
+
+// Reads `count` elements. The counts come from the header of the stream,
+// so `data` grows in steps of at most 1 MiB as the elements arrive, and a
+// corrupt count fails at the end of the stream instead of allocating it.
+template <typename T>
+static bool read_vector(
+    std::istream& in, std::uint64_t count, std::vector<T>& data,
+    const T& fill = T()) {
+  constexpr std::uint64_t step = (std::uint64_t{1} << 20) / sizeof(T);
+  data.clear();
+  while (data.size() < count) {
+    const std::size_t first = data.size();
+    data.resize(first + std::min(step, count - first), fill);
+    const auto bytes =
+        static_cast<std::streamsize>((data.size() - first) * sizeof(T));
+    in.read(reinterpret_cast<char*>(data.data() + first), bytes);
+    if (in.gcount() != bytes) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool write_expression(std::ostream& out, const Expression& expression) {
+  using Entry = Expression::ExpressionMap::value_type;
+  std::vector<const Entry*> entries;
+  entries.reserve(expression.size());
+  std::uint64_t operators = 0;
+  for (const Entry& entry : expression.terms()) {
+    entries.push_back(&entry);
+    operators += entry.first.size();
+  }
+  std::sort(entries.begin(), entries.end(), [](auto a, auto b) {
+    return operators_less(a->first, b->first);
+  });
+
+  ExpressionFileHeader header{
+      expression_magic, expression_version, byte_order_mark, entries.size(),
+      operators};
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  // Each array is written in one pass over the sorted terms, so nothing
+  // but the order is held in memory.
+  for (const Entry* entry : entries) {
+    out.write(
+        reinterpret_cast<const char*>(&entry->second),
+        sizeof(Term::CoeffType));
+  }
+  std::uint64_t offset = 0;
+  out.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+  for (const Entry* entry : entries) {
+    offset += entry->first.size();
+    out.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+  }
+  for (const Entry* entry : entries) {
+    write_span<Operator>(out, entry->first);
+  }
+  return out.good();
+}
+
+std::optional<Expression> read_expression(std::istream& in) {
+  ExpressionFileHeader header;
+  in.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!in.good() || !valid_header(header)) {
+    return std::nullopt;
+  }
+
+  std::vector<Term::CoeffType> coefficients;
+  std::vector<std::uint64_t> offsets;
+  std::vector<Operator> operators;
+  if (!read_vector(in, header.terms, coefficients) ||
+      !read_vector(in, coefficients.size() + 1, offsets) ||
+      !valid_offsets(offsets, header.operators) ||
+      !read_vector(
+          in, header.operators, operators,
+          Operator::creation<Operator::Statistics::Boson>(
+              Operator::Spin::Up, 0)) ||
+      !strictly_increasing(offsets, operators)) {
+    return std::nullopt;
+  }
+
+  Expression::ExpressionMap terms;
+  terms.reserve(coefficients.size());
+  for (std::size_t i = 0; i < coefficients.size(); i++) {
+    terms.emplace(
+        std::vector<Operator>(
+            operators.begin() + static_cast<std::ptrdiff_t>(offsets[i]),
+            operators.begin() + static_cast<std::ptrdiff_t>(offsets[i + 1])),
+        coefficients[i]);
+  }
+  return Expression(std::move(terms));
+}
+
+bool write_term(std::ostream& out, const Term& term) {
+  return write_expression(out, Expression(std::vector<Term>{term}));
+}
+
+std::optional<Term> read_term(std::istream& in) {
+  auto expression = read_expression(in);
+  if (!expression.has_value() || expression->size() != 1) {
+    return std::nullopt;
+  }
+  const auto& [operators, coefficient] = *expression->terms().begin();
+  return Term(coefficient, operators);
+}
+
+bool save_expression(const Expression& expression, const std::string& path) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  return write_expression(out, expression);
+}
+
+std::optional<Expression> load_expression(const std::string& path) {
+  auto mapped = MappedExpression::open(path);
+  if (!mapped.has_value()) {
+    return std::nullopt;
+  }
+  return mapped->expression();
+}
+
+std::optional<MappedExpression> MappedExpression::open(
+    const std::string& path) {
+  auto file = MappedFile::open(path);
+  if (!file.has_value() || file->size() < sizeof(ExpressionFileHeader)) {
+    return std::nullopt;
+  }
+
+  ExpressionFileHeader header;
+  std::memcpy(&header, file->data(), sizeof(header));
+  if (!valid_header(header) || !matches_size(header, file->size())) {
+    return std::nullopt;
+  }
+
+  MappedExpression result(std::move(*file));
+  const std::byte* data = result.m_file.data();
+  result.m_coefficients = {
+      reinterpret_cast<const Coeff*>(data + sizeof(header)), header.terms};
+  result.m_offsets = {
+      reinterpret_cast<const std::uint64_t*>(data + offsets_at(header)),
+      header.terms + 1};
+  result.m_operators = {
+      reinterpret_cast<const Operator*>(data + operators_at(header)),
+      header.operators};
+  if (!valid_offsets(result.m_offsets, header.operators) ||
+      !strictly_increasing(result.m_offsets, result.m_operators)) {
+    return std::nullopt;
+  }
+  return result;
+}
+
+std::optional<MappedExpression::Coeff> MappedExpression::find(
+    std::span<const Operator> operators) const {
+  std::size_t first = 0;
+  std::size_t last = size();
+  while (first < last) {
+    const std::size_t middle = first + (last - first) / 2;
+    if (operators_less(this->operators(middle), operators)) {
+      first = middle + 1;
+    } else {
+      last = middle;
+    }
+  }
+  if (first < size() &&
+      std::ranges::equal(this->operators(first), operators)) {
+    return m_coefficients[first];
+  }
+  return std::nullopt;
+}
+
+Expression MappedExpression::expression() const {
+  Expression::ExpressionMap terms;
+  terms.reserve(size());
+  for (std::size_t i = 0; i < size(); i++) {
+    auto ops = operators(i);
+    terms.emplace(
+        std::vector<Operator>(ops.begin(), ops.end()), m_coefficients[i]);
+  }
+  return Expression(std::move(terms));
+}
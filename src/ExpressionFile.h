@@ -0,0 +1,70 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+
+#include "Expression.h"
+#include "MappedFile.h"
+
+// Binary files of Expressions, to checkpoint large derived operators. After
+// a header, a file holds three arrays: the coefficients, the offset of the
+// operators of every term, and the operators of all terms back to back, one
+// byte each as in Operator. The terms are sorted by their operators, so
+// that a mapped file can be searched in place. As in DiskCache.h, data is
+// stored in native byte order and files from a machine with a different
+// byte order are rejected, as are files whose terms are out of order or
+// repeated.
+
+bool write_expression(std::ostream& out, const Expression& expression);
+
+// Reads an expression written by write_expression(). The hash map is sized
+// for all the terms up front, so it is never rehashed while it is filled.
+std::optional<Expression> read_expression(std::istream& in);
+
+// A Term is stored as an expression with one term.
+bool write_term(std::ostream& out, const Term& term);
+
+std::optional<Term> read_term(std::istream& in);
+
+bool save_expression(const Expression& expression, const std::string& path);
+
+std::optional<Expression> load_expression(const std::string& path);
+
+// An expression file used in place, without building a hash map.
+class MappedExpression {
+ public:
+  using Coeff = Term::CoeffType;
+
+  static std::optional<MappedExpression> open(const std::string& path);
+
+  std::size_t size() const { return m_coefficients.size(); }
+
+  std::span<const Coeff> coefficients() const { return m_coefficients; }
+
+  Coeff coefficient(std::size_t i) const { return m_coefficients[i]; }
+
+  std::span<const Operator> operators(std::size_t i) const {
+    return m_operators.subspan(m_offsets[i], m_offsets[i + 1] - m_offsets[i]);
+  }
+
+  // The coefficient of `operators`, by binary search, or nullopt if there
+  // is no such term.
+  std::optional<Coeff> find(std::span<const Operator> operators) const;
+
+  Expression expression() const;
+
+ private:
+  explicit MappedExpression(MappedFile file) : m_file(std::move(file)) {}
+
+  MappedFile m_file;
+  std::span<const Coeff> m_coefficients;
+  std::span<const std::uint64_t> m_offsets;
+  std::span<const Operator> m_operators;
+};
@@ -0,0 +1,206 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <concepts>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "Expression.h"
+#include "Term.h"
+
+// Lazy sums and products of Terms and Expressions. Instead of building a
+// hash map for every factor and intermediate result, as the operators of
+// Expression do, the lazy nodes only record the operands, and the terms of
+// the result are streamed into the destination when it is evaluated:
+//
+//   result += J * lazy(spin_x(i)) * lazy(spin_x(j));
+//
+// makes no temporary Expression, and only allocates for the terms that are
+// new in `result`. The nodes refer to their leaf operands, so they must be
+// evaluated (by +=, evaluate() or conversion to Expression) before those
+// go away, usually within the same statement.
+//
+// A node visits its terms with f(coefficient, operators), where the span of
+// operators is only valid during the call.
+
+template <typename Derived>
+class LazyBase {
+ public:
+  operator Expression() const;
+};
+
+template <typename T>
+concept LazyNode = std::derived_from<T, LazyBase<T>>;
+
+class LazyTerm : public LazyBase<LazyTerm> {
+ public:
+  explicit LazyTerm(const Term& term) : m_term{&term} {}
+
+  template <typename F>
+  void visit(F&& f) const {
+    f(m_term->coefficient(), std::span<const Operator>(m_term->operators()));
+  }
+
+ private:
+  const Term* m_term;
+};
+
+class LazyExpression : public LazyBase<LazyExpression> {
+ public:
+  explicit LazyExpression(const Expression& expression)
+      : m_expression{&expression} {}
+
+  template <typename F>
+  void visit(F&& f) const {
+    for (const auto& [operators, coefficient] : m_expression->terms()) {
+      f(coefficient, std::span<const Operator>(operators));
+    }
+  }
+
+ private:
+  const Expression* m_expression;
+};
+
+template <LazyNode E>
+class LazyScaled : public LazyBase<LazyScaled<E>> {
+ public:
+  LazyScaled(Term::CoeffType coefficient, E node)
+      : m_coefficient{coefficient}, m_node{node} {}
+
+  template <typename F>
+  void visit(F&& f) const {
+    m_node.visit([&](Term::CoeffType c, std::span<const Operator> ops) {
+      f(m_coefficient * c, ops);
+    });
+  }
+
+ private:
+  Term::CoeffType m_coefficient;
+  E m_node;
+};
+
+template <LazyNode L, LazyNode R>
+class LazySum : public LazyBase<LazySum<L, R>> {
+ public:
+  LazySum(L lhs, R rhs) : m_lhs{lhs}, m_rhs{rhs} {}
+
+  template <typename F>
+  void visit(F&& f) const {
+    m_lhs.visit(f);
+    m_rhs.visit(f);
+  }
+
+ private:
+  L m_lhs;
+  R m_rhs;
+};
+
+template <LazyNode L, LazyNode R>
+class LazyProduct : public LazyBase<LazyProduct<L, R>> {
+ public:
+  LazyProduct(L lhs, R rhs) : m_lhs{lhs}, m_rhs{rhs} {}
+
+  // Every pair of terms, concatenated in a buffer that is reused for the
+  // whole evaluation.
+  template <typename F>
+  void visit(F&& f) const {
+    std::vector<Operator> buffer;
+    m_lhs.visit([&](Term::CoeffType a, std::span<const Operator> lhs) {
+      m_rhs.visit([&](Term::CoeffType b, std::span<const Operator> rhs) {
+        buffer.assign(lhs.begin(), lhs.end());
+        buffer.insert(buffer.end(), rhs.begin(), rhs.end());
+        f(a * b, std::span<const Operator>(buffer));
+      });
+    });
+  }
+
+ private:
+  L m_lhs;
+  R m_rhs;
+};
+
+inline LazyTerm lazy(const Term& term) { return LazyTerm(term); }
+
+inline LazyExpression lazy(const Expression& expression) {
+  return LazyExpression(expression);
+}
+
+template <LazyNode E>
+E lazy(const E& node) {
+  return node;
+}
+
+// Operands that combine with a lazy node: other nodes, Terms and
+// Expressions.
+template <typename T>
+concept LazyOperand = LazyNode<T> || std::same_as<T, Term> ||
+                      std::same_as<T, Expression>;
+
+template <LazyOperand L, LazyOperand R>
+  requires(LazyNode<L> || LazyNode<R>)
+auto operator+(const L& lhs, const R& rhs) {
+  return LazySum(lazy(lhs), lazy(rhs));
+}
+
+template <LazyOperand L, LazyOperand R>
+  requires(LazyNode<L> || LazyNode<R>)
+auto operator*(const L& lhs, const R& rhs) {
+  return LazyProduct(lazy(lhs), lazy(rhs));
+}
+
+template <LazyNode E>
+auto operator*(Term::CoeffType coefficient, const E& node) {
+  return LazyScaled(coefficient, node);
+}
+
+template <LazyNode E>
+auto operator*(const E& node, Term::CoeffType coefficient) {
+  return LazyScaled(coefficient, node);
+}
+
+template <LazyNode E>
+auto operator*(double coefficient, const E& node) {
+  return LazyScaled(Term::CoeffType(coefficient), node);
+}
+
+template <LazyNode E>
+auto operator*(const E& node, double coefficient) {
+  return LazyScaled(Term::CoeffType(coefficient), node);
+}
+
+// Adds the terms of a node to `result`, like Expression::insert().
+template <LazyNode E>
+void evaluate_into(Expression& result, const E& node) {
+  auto& terms = result.terms();
+  std::vector<Operator> key;
+  node.visit([&](Term::CoeffType coefficient, std::span<const Operator> ops) {
+    key.assign(ops.begin(), ops.end());
+    auto it = terms.find(key);
+    if (it != terms.end()) {
+      it->second += coefficient;
+    } else {
+      terms.emplace(key, coefficient);
+    }
+  });
+}
+
+template <LazyNode E>
+Expression evaluate(const E& node) {
+  Expression result;
+  evaluate_into(result, node);
+  return result;
+}
+
+template <LazyNode E>
+Expression& operator+=(Expression& result, const E& node) {
+  evaluate_into(result, node);
+  return result;
+}
+
+template <typename Derived>
+LazyBase<Derived>::operator Expression() const {
+  return evaluate(static_cast<const Derived&>(*this));
+}
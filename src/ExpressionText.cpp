@@ -0,0 +1,175 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "ExpressionText.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#include "MappedFile.h"
+
+static bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+static const char* skip_blanks(const char* p, const char* end) {
+  while (p != end && is_blank(*p)) {
+    p++;
+  }
+  return p;
+}
+
+static bool parse_double(const char*& p, const char* end, double& value) {
+  const auto [next, error] = std::from_chars(p, end, value);
+  if (error != std::errc()) {
+    return false;
+  }
+  p = next;
+  return true;
+}
+
+static bool parse_coefficient(
+    const char*& p, const char* end, Term::CoeffType& coefficient) {
+  double re = 0.0;
+  double im = 0.0;
+  if (*p != '(') {
+    if (!parse_double(p, end, re)) {
+      return false;
+    }
+  } else {
+    p++;
+    if (!parse_double(p, end, re) || p == end || *p++ != ',' ||
+        !parse_double(p, end, im) || p == end || *p++ != ')') {
+      return false;
+    }
+  }
+  coefficient = {re, im};
+  return p == end || is_blank(*p);
+}
+
+static bool parse_operator(const char*& p, const char* end, Operator& op) {
+  Operator::Statistics statistics;
+  if (*p == 'c') {
+    statistics = Operator::Statistics::Fermion;
+  } else if (*p == 'b') {
+    statistics = Operator::Statistics::Boson;
+  } else {
+    return false;
+  }
+  p++;
+
+  Operator::Type type = Operator::Type::Annihilation;
+  if (p != end && *p == '+') {
+    type = Operator::Type::Creation;
+    p++;
+  }
+
+  std::size_t orbital = 0;
+  const auto [next, error] = std::from_chars(p, end, orbital);
+  if (error != std::errc() || orbital >= Operator::max_orbital()) {
+    return false;
+  }
+  p = next;
+
+  Operator::Spin spin;
+  if (p != end && *p == 'u') {
+    spin = Operator::Spin::Up;
+  } else if (p != end && *p == 'd') {
+    spin = Operator::Spin::Down;
+  } else {
+    return false;
+  }
+  p++;
+
+  op = Operator(type, statistics, spin, orbital);
+  return p == end || is_blank(*p);
+}
+
+std::optional<Expression> parse_expression(std::string_view text) {
+  Expression::ExpressionMap terms;
+  terms.reserve(
+      static_cast<std::size_t>(std::ranges::count(text, '\n')) + 1);
+
+  // The operators of a line are parsed into one reused buffer, which is
+  // only copied into the map for a term that is not there yet.
+  std::vector<Operator> operators;
+  const char* p = text.data();
+  const char* const end = p + text.size();
+  while (p != end) {
+    const char* line_end = static_cast<const char*>(
+        std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+    if (line_end == nullptr) {
+      line_end = end;
+    }
+
+    p = skip_blanks(p, line_end);
+    if (p != line_end && *p != '#') {
+      Term::CoeffType coefficient;
+      if (!parse_coefficient(p, line_end, coefficient)) {
+        return std::nullopt;
+      }
+      operators.clear();
+      for (p = skip_blanks(p, line_end); p != line_end;
+           p = skip_blanks(p, line_end)) {
+        Operator op(
+            Operator::Type::Creation, Operator::Statistics::Boson,
+            Operator::Spin::Up, 0);
+        if (!parse_operator(p, line_end, op)) {
+          return std::nullopt;
+        }
+        operators.push_back(op);
+      }
+      terms.try_emplace(operators).first->second += coefficient;
+    }
+
+    p = line_end == end ? end : line_end + 1;
+  }
+  return Expression(std::move(terms));
+}
+
+std::optional<Expression> load_expression_text(const std::string& path) {
+  auto file = MappedFile::open(path);
+  if (!file.has_value()) {
+    // Empty files cannot be mapped, but are valid.
+    std::error_code error;
+    if (std::filesystem::is_regular_file(path, error) &&
+        std::filesystem::file_size(path, error) == 0) {
+      return Expression();
+    }
+    return std::nullopt;
+  }
+  return parse_expression(std::string_view(
+      reinterpret_cast<const char*>(file->data()), file->size()));
+}
+
+static void write_double(std::ostream& out, double value) {
+  // Shortest representation that parses back to the same value.
+  char buffer[32];
+  const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  out.write(buffer, result.ptr - buffer);
+}
+
+bool write_expression_text(std::ostream& out, const Expression& expression) {
+  for (const auto& [operators, coefficient] : expression.terms()) {
+    if (coefficient.imag() == 0.0) {
+      write_double(out, coefficient.real());
+    } else {
+      out << '(';
+      write_double(out, coefficient.real());
+      out << ',';
+      write_double(out, coefficient.imag());
+      out << ')';
+    }
+    for (const Operator& op : operators) {
+      const bool fermion = op.statistics() == Operator::Statistics::Fermion;
+      out << ' ' << (fermion ? 'c' : 'b');
+      if (op.type() == Operator::Type::Creation) {
+        out << '+';
+      }
+      out << op.orbital() << (op.spin() == Operator::Spin::Up ? 'u' : 'd');
+    }
+    out << '\n';
+  }
+  return out.good();
+}
@@ -0,0 +1,35 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "Expression.h"
+
+// Text files of Expressions, to load generated bond lists and integrals
+// without writing a Model. Every line holds one term: a coefficient
+// followed by its operators, separated by blanks. The coefficient is a real
+// number, or a complex number written as (re,im). An operator is c or b,
+// for a fermion or a boson, then + for a creation operator, then its
+// orbital, then u or d for its spin. Blank lines and lines starting with #
+// are skipped, and repeated terms are summed:
+//
+//   # Hopping between orbitals 0 and 1
+//   -1 c+0u c1u
+//   -1 c+1u c0u
+//   (0.5,-0.25) b+3d b3d
+
+// Parses a whole text in one pass, straight into a hash map sized for one
+// term per line. Returns nullopt if any line is malformed.
+std::optional<Expression> parse_expression(std::string_view text);
+
+// Parses a file through a memory mapping, so it is never copied.
+std::optional<Expression> load_expression_text(const std::string& path);
+
+// Writes terms in the format above, with coefficients that parse back
+// exactly.
+bool write_expression_text(std::ostream& out, const Expression& expression);
@@ -0,0 +1,289 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "Fcidump.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <string>
+
+#include "MappedFile.h"
+
+using enum Operator::Statistics;
+using enum Operator::Spin;
+
+using Indices = std::array<std::size_t, 4>;
+
+static bool is_separator(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == ',';
+}
+
+// Splits off the next token of a line.
+static std::string_view next_token(std::string_view& line) {
+  std::size_t first = 0;
+  while (first < line.size() && is_separator(line[first])) {
+    first++;
+  }
+  std::size_t last = first;
+  while (last < line.size() && !is_separator(line[last])) {
+    last++;
+  }
+  std::string_view token = line.substr(first, last - first);
+  line.remove_prefix(last);
+  return token;
+}
+
+static std::string_view next_line(std::string_view& text) {
+  const std::size_t end = std::min(text.find('\n'), text.size());
+  std::string_view line = text.substr(0, end);
+  text.remove_prefix(std::min(end + 1, text.size()));
+  return line;
+}
+
+static bool parse_value(std::string_view token, double& value) {
+  // Fortran writes double precision exponents with a D.
+  std::string buffer;
+  if (token.find_first_of("dD") != std::string_view::npos) {
+    buffer = token;
+    std::ranges::replace(buffer, 'D', 'e');
+    std::ranges::replace(buffer, 'd', 'e');
+    token = buffer;
+  }
+  const char* end = token.data() + token.size();
+  const auto [next, error] = std::from_chars(token.data(), end, value);
+  return error == std::errc() && next == end;
+}
+
+template <typename T>
+static bool parse_integer(std::string_view token, T& value) {
+  const char* end = token.data() + token.size();
+  const auto [next, error] = std::from_chars(token.data(), end, value);
+  return error == std::errc() && next == end;
+}
+
+// The value of `key` in the upper case namelist, as in "NORB= 4".
+static std::optional<long> namelist_value(
+    const std::string& namelist, std::string_view key) {
+  for (std::size_t at = namelist.find(key); at != std::string::npos;
+       at = namelist.find(key, at + 1)) {
+    // Skip keys that only end in `key`.
+    if (at > 0 && std::isalnum(static_cast<unsigned char>(namelist[at - 1]))) {
+      continue;
+    }
+    std::string_view rest = std::string_view(namelist).substr(at + key.size());
+    while (!rest.empty() && std::isspace(static_cast<unsigned char>(rest[0]))) {
+      rest.remove_prefix(1);
+    }
+    if (rest.empty() || rest[0] != '=') {
+      continue;
+    }
+    rest.remove_prefix(1);
+    std::string_view token = next_token(rest);
+    long value = 0;
+    if (!parse_integer(token, value)) {
+      return std::nullopt;
+    }
+    return value;
+  }
+  return std::nullopt;
+}
+
+// Reads the &FCI namelist, which ends with &END or a lone /, and returns it
+// in upper case.
+static std::optional<std::string> read_namelist(std::string_view& text) {
+  std::string namelist;
+  while (!text.empty()) {
+    std::string_view line = next_line(text);
+    std::string upper(line);
+    std::ranges::transform(upper, upper.begin(), [](unsigned char c) {
+      return static_cast<char>(std::toupper(c));
+    });
+    namelist += upper;
+    namelist += '\n';
+
+    std::string_view rest = line;
+    const std::string_view token = next_token(rest);
+    if (upper.find("&END") != std::string::npos ||
+        (token == "/" && next_token(rest).empty())) {
+      return namelist;
+    }
+  }
+  return std::nullopt;
+}
+
+static std::size_t pair_index(std::size_t i, std::size_t j) {
+  return i * (i + 1) / 2 + j;
+}
+
+// The representative of the 8 equivalent (ij|kl): i >= j, k >= l and
+// ij >= kl.
+static Indices canonical(
+    std::size_t i, std::size_t j, std::size_t k, std::size_t l) {
+  if (i < j) {
+    std::swap(i, j);
+  }
+  if (k < l) {
+    std::swap(k, l);
+  }
+  if (pair_index(i, j) < pair_index(k, l)) {
+    std::swap(i, k);
+    std::swap(j, l);
+  }
+  return {i, j, k, l};
+}
+
+std::optional<Fcidump> parse_fcidump(std::string_view text, double threshold) {
+  const auto namelist = read_namelist(text);
+  if (!namelist.has_value()) {
+    return std::nullopt;
+  }
+  const auto orbitals = namelist_value(*namelist, "NORB");
+  const auto electrons = namelist_value(*namelist, "NELEC");
+  const auto ms2 = namelist_value(*namelist, "MS2");
+  if (!orbitals.has_value() || *orbitals <= 0 ||
+      static_cast<std::size_t>(*orbitals) > Operator::max_orbital() ||
+      electrons.value_or(0) < 0) {
+    return std::nullopt;
+  }
+
+  Fcidump result;
+  result.orbitals = static_cast<std::size_t>(*orbitals);
+  result.electrons = static_cast<std::size_t>(electrons.value_or(0));
+  result.ms2 = static_cast<int>(ms2.value_or(0));
+
+  while (!text.empty()) {
+    std::string_view line = next_line(text);
+    const std::string_view first = next_token(line);
+    if (first.empty()) {
+      continue;
+    }
+    double value = 0.0;
+    Indices indices;
+    if (!parse_value(first, value)) {
+      return std::nullopt;
+    }
+    for (std::size_t& index : indices) {
+      if (!parse_integer(next_token(line), index) ||
+          index > result.orbitals) {
+        return std::nullopt;
+      }
+    }
+    if (!next_token(line).empty()) {
+      return std::nullopt;
+    }
+
+    const auto [i, j, k, l] = indices;
+    if (i == 0 && j == 0 && k == 0 && l == 0) {
+      result.core_energy += value;
+    } else if (i == 0 || (j == 0 && (k != 0 || l != 0)) ||
+               (k == 0) != (l == 0)) {
+      return std::nullopt;
+    } else if (j == 0 || std::abs(value) <= threshold) {
+      // An orbital energy, or a negligible integral.
+    } else if (k == 0) {
+      result.one_body.push_back(
+          {std::max(i, j) - 1, std::min(i, j) - 1, value});
+    } else {
+      result.two_body.push_back({canonical(i - 1, j - 1, k - 1, l - 1), value});
+    }
+  }
+
+  // Files may list equivalent integrals more than once; keep the first.
+  std::ranges::stable_sort(result.one_body, [](const auto& a, const auto& b) {
+    return std::pair(a.i, a.j) < std::pair(b.i, b.j);
+  });
+  const auto [one_first, one_last] =
+      std::ranges::unique(result.one_body, [](const auto& a, const auto& b) {
+        return a.i == b.i && a.j == b.j;
+      });
+  result.one_body.erase(one_first, one_last);
+  std::ranges::stable_sort(result.two_body, {}, &Fcidump::TwoBody::indices);
+  const auto [two_first, two_last] =
+      std::ranges::unique(result.two_body, {}, &Fcidump::TwoBody::indices);
+  result.two_body.erase(two_first, two_last);
+  return result;
+}
+
+std::optional<Fcidump> load_fcidump(const std::string& path, double threshold) {
+  auto file = MappedFile::open(path);
+  if (!file.has_value()) {
+    return std::nullopt;
+  }
+  return parse_fcidump(
+      std::string_view(
+          reinterpret_cast<const char*>(file->data()), file->size()),
+      threshold);
+}
+
+// The distinct index orders equivalent to (ij|kl), at most 8.
+static std::vector<Indices> permutations(const Indices& indices) {
+  const auto [i, j, k, l] = indices;
+  std::vector<Indices> result = {
+      {i, j, k, l}, {j, i, k, l}, {i, j, l, k}, {j, i, l, k},
+      {k, l, i, j}, {l, k, i, j}, {k, l, j, i}, {l, k, j, i}};
+  std::ranges::sort(result);
+  const auto [first, last] = std::ranges::unique(result);
+  result.erase(first, last);
+  return result;
+}
+
+static void add(Expression::ExpressionMap& terms, Term&& term) {
+  terms[std::move(term.operators())] += term.coefficient();
+}
+
+Expression molecular_hamiltonian(const Fcidump& integrals) {
+  const std::size_t n = integrals.orbitals;
+  std::vector<std::vector<Indices>> expanded;
+  expanded.reserve(integrals.two_body.size());
+  std::size_t two_body_terms = 0;
+  for (const auto& integral : integrals.two_body) {
+    expanded.push_back(permutations(integral.indices));
+    two_body_terms += 4 * expanded.back().size();
+  }
+
+  // h_ps - 1/2 sum_q (pq|qs), as a dense matrix.
+  std::vector<double> h(n * n, 0.0);
+  for (const auto& [i, j, value] : integrals.one_body) {
+    h[i * n + j] += value;
+    if (i != j) {
+      h[j * n + i] += value;
+    }
+  }
+  for (std::size_t m = 0; m < integrals.two_body.size(); m++) {
+    for (const auto& [p, q, r, s] : expanded[m]) {
+      if (q == r) {
+        h[p * n + s] -= 0.5 * integrals.two_body[m].value;
+      }
+    }
+  }
+
+  Expression::ExpressionMap terms;
+  terms.reserve(1 + 2 * n * n + two_body_terms);
+  if (integrals.core_energy != 0.0) {
+    terms.emplace(std::vector<Operator>(), integrals.core_energy);
+  }
+  for (std::size_t p = 0; p < n; p++) {
+    for (std::size_t q = 0; q < n; q++) {
+      if (h[p * n + q] == 0.0) {
+        continue;
+      }
+      for (Operator::Spin spin : {Up, Down}) {
+        add(terms, one_body<Fermion>(h[p * n + q], spin, p, spin, q));
+      }
+    }
+  }
+  for (std::size_t m = 0; m < integrals.two_body.size(); m++) {
+    const double coefficient = 0.5 * integrals.two_body[m].value;
+    for (const auto& [p, q, r, s] : expanded[m]) {
+      for (Operator::Spin s1 : {Up, Down}) {
+        for (Operator::Spin s2 : {Up, Down}) {
+          add(terms,
+              two_body<Fermion>(coefficient, s1, p, s1, q, s2, r, s2, s));
+        }
+      }
+    }
+  }
+  return Expression(std::move(terms));
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Expression.h"
+
+// Real molecular integrals in the FCIDUMP format: a &FCI namelist with
+// NORB, NELEC and MS2, then one integral per line, as a value followed by
+// four 1-based orbital indices i j k l:
+//
+//   (ij|kl)  if all indices are nonzero,
+//   h_ij     if k = l = 0,
+//   E_core   if all indices are zero.
+//
+// Lines with only i nonzero hold orbital energies, and are ignored. Two
+// electron integrals are in chemists' notation, and real orbitals give
+// them the 8-fold symmetry
+//
+//   (ij|kl) = (ji|kl) = (ij|lk) = (ji|lk) = (kl|ij) = ... ,
+//
+// so only one of the equivalent integrals is stored, with i >= j, k >= l
+// and ij >= kl as pairs. Likewise only h_ij with i >= j is stored.
+struct Fcidump {
+  struct OneBody {
+    std::size_t i;
+    std::size_t j;
+    double value;
+  };
+
+  struct TwoBody {
+    std::array<std::size_t, 4> indices;
+    double value;
+  };
+
+  std::size_t orbitals = 0;
+  std::size_t electrons = 0;
+  int ms2 = 0;
+  double core_energy = 0.0;
+  // Unique integrals with 0-based indices, sorted by their indices.
+  std::vector<OneBody> one_body;
+  std::vector<TwoBody> two_body;
+};
+
+// Integrals with an absolute value of at most `threshold` are dropped.
+// Returns nullopt if the file is malformed, or if it has more orbitals than
+// an Operator can address.
+std::optional<Fcidump> parse_fcidump(
+    std::string_view text, double threshold = 0.0);
+
+std::optional<Fcidump> load_fcidump(
+    const std::string& path, double threshold = 0.0);
+
+// The electronic Hamiltonian
+//
+//   H = E_core + sum_{pq,s} h_pq c+(p,s) c(q,s)
+//       + 1/2 sum_{pqrs,st} (pq|rs) c+(p,s) c+(r,t) c(s,t) c(q,s).
+//
+// The two-body part is expanded with two_body() as
+// c+(p,s) c(q,s) c+(r,t) c(s,t), which moves -1/2 sum_q (pq|qs) into the
+// one-body part. Each unique integral is expanded into its distinct
+// permutations only.
+Expression molecular_hamiltonian(const Fcidump& integrals);
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "Basis.h"
+#include "TaskScheduler.h"
 
 class FermionicBasis final : public Basis {
  public:
@@ -11,26 +12,117 @@ class FermionicBasis final : public Basis {
       std::size_t n, std::size_t m, BasisFilter *filter,
       bool allow_double_occupancy)
       : Basis(n, m, filter), m_allow_double_occupancy{allow_double_occupancy} {
-    generate_basis();
+    generate_basis_parallel();
   }
 
   FermionicBasis(std::size_t n, std::size_t m, bool allow_double_occupancy)
       : Basis(n, m), m_allow_double_occupancy{allow_double_occupancy} {
-    generate_basis();
+    generate_basis_parallel();
   }
 
   FermionicBasis(std::size_t n, std::size_t m, BasisFilter *filter)
       : Basis(n, m, filter), m_allow_double_occupancy{true} {
-    generate_basis();
+    generate_basis_parallel();
   }
 
   FermionicBasis(std::size_t n, std::size_t m)
       : Basis(n, m), m_allow_double_occupancy{true} {
-    generate_basis();
+    generate_basis_parallel();
+  }
+
+  // The compile-time filter is inlined into the enumeration. It is also kept
+  // as a BasisFilter so that the basis behaves as if built from one.
+  template <typename F>
+  FermionicBasis(
+      std::size_t n, std::size_t m, ElementFilter<F> filter,
+      bool allow_double_occupancy = true)
+      : Basis(n, m, make_basis_filter(filter)),
+        m_allow_double_occupancy{allow_double_occupancy} {
+    generate_basis_parallel(filter);
   }
 
   void generate_combinations(BasisElement &, size_t, size_t, size_t) override;
 
  private:
+  // Same enumeration as generate_basis(), but the subtrees below the first
+  // occupied spin-orbitals are expanded concurrently and concatenated in
+  // canonical order, so the indices do not depend on the number of threads.
+  template <typename Filter>
+  void generate_basis_parallel(const Filter &filter);
+
+  // Runs the parallel enumeration with the runtime BasisFilter.
+  void generate_basis_parallel();
+
+  template <typename Visitor>
+  void visit_combinations(
+      BasisElement &, std::size_t, std::size_t, std::size_t,
+      Visitor &&) const;
+
   bool m_allow_double_occupancy;
 };
+
+template <typename Visitor>
+void FermionicBasis::visit_combinations(
+    BasisElement &current, std::size_t first_orbital, std::size_t depth,
+    std::size_t max_depth, Visitor &&visit) const {
+  if (depth == max_depth) {
+    visit(current);
+    return;
+  }
+
+  for (std::size_t i = first_orbital; i < m_orbitals; i++) {
+    for (int spin_index = 0; spin_index < 2; ++spin_index) {
+      Operator::Spin spin = static_cast<Operator::Spin>(spin_index);
+      if (current.empty() || current.back().orbital() < i ||
+          (m_allow_double_occupancy &&
+           (current.back().orbital() == i && spin > current.back().spin()))) {
+        current.push_back(Operator(
+            Operator::Type::Creation, Operator::Statistics::Fermion, spin, i));
+        visit_combinations(current, i, depth + 1, max_depth, visit);
+        current.pop_back();
+      }
+    }
+  }
+}
+
+template <typename Filter>
+void FermionicBasis::generate_basis_parallel(const Filter &filter) {
+  // Two occupied spin-orbitals give enough (and small enough) subtrees to
+  // balance the work between threads.
+  const std::size_t prefix_depth = std::min<std::size_t>(m_particles, 2);
+
+  std::vector<BasisElement> prefixes;
+  BasisElement current;
+  visit_combinations(
+      current, 0, 0, prefix_depth,
+      [&prefixes](const BasisElement &prefix) { prefixes.push_back(prefix); });
+
+  std::vector<std::vector<BasisElement>> chunks(prefixes.size());
+
+  TaskScheduler::current().parallel_for(
+      0, prefixes.size(), 1, [&](std::size_t i) {
+        BasisElement element = prefixes[i];
+        element.reserve(m_particles);
+        const std::size_t first_orbital =
+            element.empty() ? 0 : element.back().orbital();
+        visit_combinations(
+            element, first_orbital, prefix_depth, m_particles,
+            [&filter, &chunk = chunks[i]](const BasisElement &e) {
+              if (filter(e)) {
+                chunk.push_back(e);
+              }
+            });
+      });
+
+  std::size_t total = 0;
+  for (const std::vector<BasisElement> &chunk : chunks) {
+    total += chunk.size();
+  }
+
+  m_basis_map.reserve(total);
+  for (std::vector<BasisElement> &chunk : chunks) {
+    for (BasisElement &element : chunk) {
+      m_basis_map.insert(std::move(element));
+    }
+  }
+}
@@ -14,5 +14,46 @@ class GenericBasis : public Basis {
     generate_basis();
   }
 
+  template <typename F>
+  GenericBasis(std::size_t n, std::size_t m, ElementFilter<F> filter)
+      : Basis(n, m, make_basis_filter(filter)) {
+    BasisElement current;
+    current.reserve(m_particles);
+    generate_filtered(current, 0, 0, m_particles, filter);
+  }
+
   void generate_combinations(BasisElement &, size_t, size_t, size_t) override;
+
+ private:
+  template <typename Filter>
+  void generate_filtered(
+      BasisElement &, std::size_t, std::size_t, std::size_t, const Filter &);
 };
+
+template <typename Filter>
+void GenericBasis::generate_filtered(
+    BasisElement &current, std::size_t first_orbital, std::size_t depth,
+    std::size_t max_depth, const Filter &filter) {
+  if (filter(current)) {
+    m_basis_map.insert(current);
+  }
+
+  if (depth == max_depth) {
+    return;
+  }
+
+  for (std::size_t orbital_index = first_orbital; orbital_index < m_orbitals;
+       orbital_index++) {
+    // TODO: bosonic operator should be integer spin
+    auto spin = Operator::Spin::Up;
+    if (current.empty() || current.back().orbital() <= orbital_index) {
+      // In the generic case, we just create a basis with (single-spin) bosons
+      // with all possible particles configurations (0..orbitals)
+      current.push_back(Operator(
+          Operator::Type::Creation, Operator::Statistics::Boson, spin,
+          orbital_index));
+      generate_filtered(current, orbital_index, depth + 1, max_depth, filter);
+      current.pop_back();
+    }
+  }
+}
@@ -0,0 +1,209 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "GrandCanonicalBuilder.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+
+#include "Assert.h"
+#include "Basis.h"
+#include "TaskScheduler.h"
+
+static constexpr std::uint64_t up_bits = 0x5555555555555555;
+
+// Rows per task of the assembly.
+static constexpr std::size_t chunk_rows = 1024;
+
+GrandCanonicalBuilder::GrandCanonicalBuilder(
+    std::size_t orbitals, const Expression& hamiltonian)
+    : m_orbitals{orbitals}, m_diagonal{orbitals} {
+  if (orbitals > 32) {
+    throw std::invalid_argument(
+        "GrandCanonicalBuilder: at most 32 orbitals fit an occupation word");
+  }
+  Expression remainder = hamiltonian;
+  m_diagonal = DiagonalOperator::split(remainder, orbitals);
+
+  for (const auto& [operators, coefficient] : remainder.terms()) {
+    CompiledTerm term{0, 0, operators, coefficient};
+    std::uint64_t created = 0;
+    int balance[2] = {0, 0};
+    for (const Operator& op : operators) {
+      if (!op.is_fermion() || op.orbital() >= orbitals) {
+        throw std::invalid_argument(
+            "GrandCanonicalBuilder: terms must be fermionic and within the "
+            "orbitals");
+      }
+      const auto spin = static_cast<std::size_t>(op.spin());
+      const std::uint64_t bit = std::uint64_t{1}
+                                << (2 * op.orbital() + spin);
+      if (op.type() == Operator::Type::Creation) {
+        created |= bit;
+        balance[spin]++;
+      } else {
+        term.occupied |= bit;
+        balance[spin]--;
+      }
+    }
+    // The image of a state must be in the sector of the state, or the rows
+    // would point outside of the block.
+    if (balance[0] != 0 || balance[1] != 0) {
+      throw std::invalid_argument(
+          "GrandCanonicalBuilder: terms must conserve the electrons of each "
+          "spin");
+    }
+    term.empty = created & ~term.occupied;
+    m_terms.push_back(std::move(term));
+  }
+}
+
+std::vector<SectorBlock> GrandCanonicalBuilder::build(
+    const std::vector<std::size_t>& particles,
+    std::optional<int> total_spin) const {
+  // Enumerate each particle number once, even if it is repeated, and sort
+  // the states into their spin sectors; increasing words stay increasing.
+  std::vector<std::size_t> numbers = particles;
+  std::sort(numbers.begin(), numbers.end());
+  numbers.erase(std::unique(numbers.begin(), numbers.end()), numbers.end());
+  std::map<std::pair<std::size_t, int>, std::vector<std::uint64_t>> sectors;
+  const std::size_t modes = 2 * m_orbitals;
+  for (std::size_t n : numbers) {
+    if (n > modes) {
+      throw std::invalid_argument(
+          "GrandCanonicalBuilder: more particles than spin-orbitals");
+    }
+    auto add = [&](std::uint64_t word) {
+      const int up = std::popcount(word & up_bits);
+      const int spin = std::popcount(word) - 2 * up;
+      if (!total_spin.has_value() || *total_spin == spin) {
+        sectors[{n, spin}].push_back(word);
+      }
+    };
+    if (n == 0) {
+      add(0);
+      continue;
+    }
+    // Gosper's hack, as in HubbardEngine.
+    const std::uint64_t lowest =
+        n == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << n) - 1;
+    const std::uint64_t last = lowest << (modes - n);
+    for (std::uint64_t s = lowest;;) {
+      add(s);
+      if (s == last) {
+        break;
+      }
+      const std::uint64_t c = s & (~s + 1);
+      const std::uint64_t r = s + c;
+      s = (((r ^ s) >> 2) / c) | r;
+    }
+  }
+
+  std::vector<SectorBlock> result;
+  struct Chunk {
+    std::size_t block;
+    std::size_t first;
+    std::size_t last;
+    std::vector<std::size_t> counts;
+    std::vector<CsrMatrix<Coeff>::Index> columns;
+    std::vector<Coeff> values;
+  };
+  std::vector<Chunk> chunks;
+  std::size_t offset = 0;
+  for (auto& [key, states] : sectors) {
+    const std::size_t size = states.size();
+    for (std::size_t first = 0; first < size; first += chunk_rows) {
+      chunks.push_back(
+          {result.size(), first, std::min(size, first + chunk_rows), {}, {},
+           {}});
+    }
+    result.push_back({key.first, key.second, offset, std::move(states), {}});
+    offset += size;
+  }
+
+  // One pass over the rows of all the blocks. Each chunk keeps its rows in
+  // compressed form; the blocks are stitched together afterwards.
+  TaskScheduler::current().parallel_for(
+      0, chunks.size(), 1, [&](std::size_t k) {
+        Chunk& chunk = chunks[k];
+        const auto& states = result[chunk.block].states;
+        Row row;
+        for (std::size_t i = chunk.first; i < chunk.last; i++) {
+          row.clear();
+          compute_row(states, i, row);
+          chunk.counts.push_back(row.size());
+          for (const auto& [j, value] : row) {
+            chunk.columns.push_back(static_cast<CsrMatrix<Coeff>::Index>(j));
+            chunk.values.push_back(value);
+          }
+        }
+      });
+
+  std::vector<std::vector<std::size_t>> block_chunks(result.size());
+  for (std::size_t k = 0; k < chunks.size(); k++) {
+    block_chunks[chunks[k].block].push_back(k);
+  }
+  TaskScheduler::current().parallel_for(
+      0, result.size(), 1, [&](std::size_t b) {
+        const std::size_t size = result[b].states.size();
+        std::vector<CsrMatrix<Coeff>::Offset> offsets(size + 1, 0);
+        std::vector<CsrMatrix<Coeff>::Index> columns;
+        std::vector<Coeff> values;
+        for (std::size_t k : block_chunks[b]) {
+          Chunk& chunk = chunks[k];
+          for (std::size_t i = chunk.first; i < chunk.last; i++) {
+            offsets[i + 1] = offsets[i] + chunk.counts[i - chunk.first];
+          }
+          columns.insert(
+              columns.end(), chunk.columns.begin(), chunk.columns.end());
+          values.insert(values.end(), chunk.values.begin(), chunk.values.end());
+          chunk = Chunk{};
+        }
+        result[b].matrix = CsrMatrix<Coeff>(
+            size, size, std::move(offsets), std::move(columns),
+            std::move(values));
+      });
+  return result;
+}
+
+void GrandCanonicalBuilder::compute_row(
+    const std::vector<std::uint64_t>& states, std::size_t i, Row& row) const {
+  const std::uint64_t word = states[i];
+  const double energy = m_diagonal(word);
+  if (std::abs(energy) > 0.0) {
+    row.emplace_back(i, energy);
+  }
+
+  for (const CompiledTerm& term : m_terms) {
+    if ((word & term.occupied) != term.occupied ||
+        (word & term.empty) != 0) {
+      continue;
+    }
+    auto image = apply_operators(term.operators, word);
+    if (!image.has_value()) {
+      continue;
+    }
+    auto it = std::lower_bound(states.begin(), states.end(), image->first);
+    LIBMB_ASSERT(it != states.end() && *it == image->first);
+    row.emplace_back(
+        static_cast<std::size_t>(it - states.begin()),
+        static_cast<double>(image->second) * term.coefficient);
+  }
+
+  // Several terms can connect the same states.
+  std::sort(row.begin(), row.end(), [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  });
+  std::size_t size = 0;
+  for (std::size_t k = 0; k < row.size(); k++) {
+    if (size > 0 && row[size - 1].first == row[k].first) {
+      row[size - 1].second += row[k].second;
+    } else {
+      row[size++] = row[k];
+    }
+  }
+  row.resize(size);
+}
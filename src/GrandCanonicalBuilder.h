@@ -0,0 +1,70 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "CsrMatrix.h"
+#include "DiagonalOperator.h"
+#include "Expression.h"
+
+// Hamiltonian block of one (particle number, total spin) sector.
+struct SectorBlock {
+  std::size_t particles;
+  // As in TotalSpinFilter: the number of down minus up electrons.
+  int total_spin;
+  // Index of the first state of the sector in the joint numbering of all
+  // the sectors that were built together.
+  std::size_t offset;
+  // Occupation words (see occupation_bits()) of the states, increasing.
+  std::vector<std::uint64_t> states;
+  // mat(i, j) = <j|H|i>, as in Model::compute_matrix_elements().
+  CsrMatrix<Term::CoeffType> matrix;
+};
+
+// Builds the blocks of many particle number and spin sectors of a fermionic
+// Hamiltonian at once. The Hamiltonian is compiled a single time: density
+// terms into a DiagonalOperator, the others into masks that reject the
+// states they annihilate, and they act on occupation words without any
+// normal ordering. The states of all the sectors are numbered jointly and
+// the rows of all the blocks are computed in one parallel pass.
+//
+// Every term must conserve the number of electrons of each spin.
+class GrandCanonicalBuilder {
+ public:
+  using Coeff = Term::CoeffType;
+
+  // Throws std::invalid_argument for more than 32 orbitals, and for terms
+  // that are not fermionic or do not conserve the electrons of each spin.
+  GrandCanonicalBuilder(std::size_t orbitals, const Expression& hamiltonian);
+
+  // Every sector with a number of electrons in `particles`, or only the
+  // ones with the given total spin. Sectors without states are left out,
+  // and repeated numbers are built once. Throws std::invalid_argument for
+  // more particles than spin-orbitals.
+  std::vector<SectorBlock> build(
+      const std::vector<std::size_t>& particles,
+      std::optional<int> total_spin = std::nullopt) const;
+
+ private:
+  struct CompiledTerm {
+    // Spin-orbitals the term needs occupied and empty to act.
+    std::uint64_t occupied;
+    std::uint64_t empty;
+    std::vector<Operator> operators;
+    Coeff coefficient;
+  };
+
+  using Row = std::vector<std::pair<std::size_t, Coeff>>;
+
+  void compute_row(
+      const std::vector<std::uint64_t>& states, std::size_t i,
+      Row& row) const;
+
+  std::size_t m_orbitals;
+  DiagonalOperator m_diagonal;
+  std::vector<CompiledTerm> m_terms;
+};
@@ -0,0 +1,253 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "HubbardEngine.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <stdexcept>
+
+#include "Basis.h"
+#include "DiagonalKernel.h"
+#include "SparseMatrix.h"
+#include "TaskScheduler.h"
+
+// Moves bit i of a 32-bit mask to bit 2 * i.
+static std::uint64_t spread_bits(std::uint64_t x) {
+  x = (x | (x << 16)) & 0x0000ffff0000ffff;
+  x = (x | (x << 8)) & 0x00ff00ff00ff00ff;
+  x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0f;
+  x = (x | (x << 2)) & 0x3333333333333333;
+  x = (x | (x << 1)) & 0x5555555555555555;
+  return x;
+}
+
+// Terms that leave every occupation unchanged, i.e. with as many creation
+// as annihilation operators on each spin-orbital.
+static bool is_diagonal(const std::vector<Operator>& operators) {
+  std::array<int, 64> balance{};
+  for (const Operator& op : operators) {
+    const std::size_t k =
+        2 * op.orbital() + static_cast<std::size_t>(op.spin());
+    balance[k] += op.type() == Operator::Type::Creation ? 1 : -1;
+  }
+  return std::all_of(
+      balance.begin(), balance.end(), [](int b) { return b == 0; });
+}
+
+// Calls f(first, last) for consecutive blocks of the `rows` rows, in
+// parallel. There are a few blocks per thread, so that the buffers of a
+// block are allocated once for many rows.
+template <typename F>
+static void for_each_row_block(std::size_t rows, F&& f) {
+  TaskScheduler& scheduler = TaskScheduler::current();
+  const std::size_t blocks = std::min(rows, 4 * scheduler.concurrency());
+  scheduler.parallel_for(0, blocks, 1, [&](std::size_t b) {
+    f(b * rows / blocks, (b + 1) * rows / blocks);
+  });
+}
+
+HubbardEngine::HubbardEngine(
+    std::size_t orbitals, std::size_t up_particles,
+    std::size_t down_particles, const Expression& hamiltonian,
+    DiagonalStorage storage)
+    : m_orbitals{orbitals},
+      m_up_states{spinless_states(orbitals, up_particles)},
+      m_down_states{spinless_states(orbitals, down_particles)},
+      m_diagonal_operator{orbitals, OccupationLayout::SpinBlocked},
+      m_storage{storage} {
+  Expression remainder = hamiltonian;
+  m_diagonal_operator = DiagonalOperator::split(
+      remainder, orbitals, OccupationLayout::SpinBlocked);
+
+  std::vector<Hopping> up_hoppings;
+  std::vector<Hopping> down_hoppings;
+  std::vector<std::pair<std::vector<Operator>, Coeff>> diagonal_terms;
+
+  for (const auto& [operators, coefficient] : remainder.terms()) {
+    if (!std::all_of(
+            operators.begin(), operators.end(), [orbitals](const Operator& op) {
+              return op.is_fermion() && op.orbital() < orbitals;
+            })) {
+      throw std::invalid_argument(
+          "HubbardEngine: terms must be fermionic and within the orbitals");
+    }
+    if (is_diagonal(operators)) {
+      diagonal_terms.emplace_back(operators, coefficient);
+      continue;
+    }
+
+    if (operators.size() != 2 ||
+        operators[0].type() != Operator::Type::Creation ||
+        operators[1].type() != Operator::Type::Annihilation ||
+        operators[0].spin() != operators[1].spin()) {
+      throw std::invalid_argument(
+          "HubbardEngine: off-diagonal terms must be spin-conserving "
+          "hoppings");
+    }
+    const Operator& creation = operators[0];
+    const Operator& annihilation = operators[1];
+    Hopping hopping{annihilation.orbital(), creation.orbital(), coefficient};
+    (creation.spin() == Operator::Spin::Up ? up_hoppings : down_hoppings)
+        .push_back(hopping);
+  }
+
+  m_up_hopping = hopping_matrix(m_up_states, up_hoppings);
+  m_down_hopping = hopping_matrix(m_down_states, down_hoppings);
+  if (storage == DiagonalStorage::OnTheFly && !diagonal_terms.empty()) {
+    throw std::invalid_argument(
+        "HubbardEngine: OnTheFly storage only supports density terms");
+  }
+  if (storage == DiagonalStorage::Stored) {
+    compute_diagonal(diagonal_terms);
+  }
+}
+
+std::uint64_t HubbardEngine::word(std::size_t i) const {
+  const std::size_t n = down_size();
+  return spread_bits(m_up_states[i / n]) |
+         (spread_bits(m_down_states[i % n]) << 1);
+}
+
+std::vector<std::uint64_t> HubbardEngine::spinless_states(
+    std::size_t orbitals, std::size_t particles) {
+  // Called first by the constructor, so nothing is built for invalid sizes.
+  if (orbitals > 32) {
+    throw std::invalid_argument(
+        "HubbardEngine: at most 32 orbitals fit an occupation word");
+  }
+  if (particles > orbitals) {
+    throw std::invalid_argument(
+        "HubbardEngine: more particles of one spin than orbitals");
+  }
+  std::vector<std::uint64_t> result;
+  if (particles == 0) {
+    result.push_back(0);
+    return result;
+  }
+
+  // Gosper's hack: the next larger word with the same number of bits.
+  const std::uint64_t end = std::uint64_t{1} << orbitals;
+  for (std::uint64_t s = (std::uint64_t{1} << particles) - 1; s < end;) {
+    result.push_back(s);
+    const std::uint64_t c = s & (~s + 1);
+    const std::uint64_t r = s + c;
+    s = (((r ^ s) >> 2) / c) | r;
+  }
+  return result;
+}
+
+CsrMatrix<HubbardEngine::Coeff> HubbardEngine::hopping_matrix(
+    const std::vector<std::uint64_t>& states,
+    const std::vector<Hopping>& hoppings) {
+  SparseMatrix<Coeff> matrix;
+  for (std::size_t column = 0; column < states.size(); column++) {
+    const std::uint64_t state = states[column];
+    for (const Hopping& hopping : hoppings) {
+      const std::uint64_t from = std::uint64_t{1} << hopping.from;
+      const std::uint64_t to = std::uint64_t{1} << hopping.to;
+      if ((state & from) == 0 || (state & to) != 0) {
+        continue;
+      }
+      // The electron passes the ones on the orbitals in between.
+      const std::uint64_t between =
+          (std::max(from, to) - 1) & ~(2 * std::min(from, to) - 1);
+      const double sign = std::popcount(state & between) % 2 == 0 ? 1.0 : -1.0;
+      const std::uint64_t target = state ^ from ^ to;
+      const auto row = static_cast<std::size_t>(
+          std::lower_bound(states.begin(), states.end(), target) -
+          states.begin());
+      matrix(row, column) += sign * hopping.coefficient;
+    }
+  }
+  return CsrMatrix<Coeff>(states.size(), states.size(), matrix);
+}
+
+void HubbardEngine::compute_diagonal(
+    const std::vector<std::pair<std::vector<Operator>, Coeff>>& terms) {
+  m_diagonal.resize(size());
+  const std::size_t n = down_size();
+  for_each_row_block(up_size(), [&](std::size_t first, std::size_t last) {
+    std::vector<std::uint64_t> words(n);
+    for (std::size_t u = first; u < last; u++) {
+      std::span<double> energies(m_diagonal.data() + u * n, n);
+      row_energies(u, words, energies);
+      if (terms.empty()) {
+        continue;
+      }
+      // Other diagonal terms go through the generic (slow) path.
+      for (std::size_t d = 0; d < n; d++) {
+        const std::uint64_t state = word(u * n + d);
+        for (const auto& [operators, coefficient] : terms) {
+          auto result = apply_operators(operators, state);
+          if (result.has_value()) {
+            energies[d] += result->second * coefficient.real();
+          }
+        }
+      }
+    }
+  });
+}
+
+void HubbardEngine::row_energies(
+    std::size_t u, std::span<std::uint64_t> words,
+    std::span<double> energies) const {
+  const std::uint64_t up = m_up_states[u];
+  for (std::size_t d = 0; d < words.size(); d++) {
+    words[d] = up | (m_down_states[d] << m_orbitals);
+  }
+  evaluate_diagonal(m_diagonal_operator, words, energies);
+}
+
+void HubbardEngine::apply(std::span<const Coeff> x, std::span<Coeff> y) const {
+  if (x.size() != size() || y.size() != size()) {
+    throw std::invalid_argument(
+        "HubbardEngine: vectors must have one entry per state");
+  }
+  const std::size_t n = down_size();
+  const auto up_offsets = m_up_hopping.row_offsets();
+  const auto up_columns = m_up_hopping.columns();
+  const auto up_values = m_up_hopping.values();
+  const auto down_offsets = m_down_hopping.row_offsets();
+  const auto down_columns = m_down_hopping.columns();
+  const auto down_values = m_down_hopping.values();
+
+  const bool on_the_fly = m_storage == DiagonalStorage::OnTheFly;
+
+  for_each_row_block(up_size(), [&](std::size_t first, std::size_t last) {
+    std::vector<std::uint64_t> words(on_the_fly ? n : 0);
+    std::vector<double> energies(on_the_fly ? n : 0);
+    for (std::size_t u = first; u < last; u++) {
+      const Coeff* in = x.data() + u * n;
+      Coeff* out = y.data() + u * n;
+      if (on_the_fly) {
+        row_energies(u, words, energies);
+      }
+      const double* diagonal =
+          on_the_fly ? energies.data() : m_diagonal.data() + u * n;
+
+      for (std::size_t d = 0; d < n; d++) {
+        out[d] = diagonal[d] * in[d];
+      }
+
+      // T_up x 1 mixes whole rows.
+      for (std::size_t k = up_offsets[u]; k < up_offsets[u + 1]; k++) {
+        const Coeff t = up_values[k];
+        const Coeff* row = x.data() + up_columns[k] * n;
+        for (std::size_t d = 0; d < n; d++) {
+          out[d] += t * row[d];
+        }
+      }
+
+      // 1 x T_down acts within the row.
+      for (std::size_t d = 0; d < n; d++) {
+        Coeff sum = 0.0;
+        for (std::size_t k = down_offsets[d]; k < down_offsets[d + 1]; k++) {
+          sum += down_values[k] * in[down_columns[k]];
+        }
+        out[d] += sum;
+      }
+    }
+  });
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "CsrMatrix.h"
+#include "DiagonalOperator.h"
+#include "Expression.h"
+
+// Matrix-free Hamiltonian for models whose hopping conserves spin, such as
+// the Hubbard models. The states are products |up> |down> of a spinless
+// state of the up electrons and one of the down electrons, so that
+//
+//   H = T_up x 1 + 1 x T_down + D
+//
+// with T_up and T_down acting on the (small) spinless spaces and D diagonal.
+// Only these three pieces are stored. A vector is indexed as a matrix with
+// one row per up state, i = up_index * down_size() + down_index.
+//
+// Product states order the creation operators of all up electrons before
+// those of the down electrons. The matrix therefore differs from the one in
+// a FermionicBasis by the signs of the basis states, which does not change
+// the spectrum.
+class HubbardEngine {
+ public:
+  using Coeff = Term::CoeffType;
+
+  enum class DiagonalStorage {
+    // D is computed once and kept, one double per state.
+    Stored,
+    // D is recomputed by every apply(), a row of states at a time with the
+    // SIMD kernel of DiagonalKernel.h. This saves a vector worth of memory
+    // for a few popcounts per state, but requires every diagonal term to go
+    // into diagonal_operator().
+    OnTheFly,
+  };
+
+  // The Hamiltonian may only contain terms that are diagonal in the
+  // occupations (densities, interactions, constants) and spin-conserving
+  // one-body terms c+(i, s) c(j, s). Throws std::invalid_argument for any
+  // other term, for diagonal terms that OnTheFly storage cannot evaluate,
+  // for more than 32 orbitals and for more particles of a spin than
+  // orbitals.
+  HubbardEngine(
+      std::size_t orbitals, std::size_t up_particles,
+      std::size_t down_particles, const Expression& hamiltonian,
+      DiagonalStorage storage = DiagonalStorage::Stored);
+
+  std::size_t orbitals() const { return m_orbitals; }
+
+  std::size_t size() const { return m_up_states.size() * m_down_states.size(); }
+
+  std::size_t up_size() const { return m_up_states.size(); }
+
+  std::size_t down_size() const { return m_down_states.size(); }
+
+  // Spinless states as bit masks of occupied orbitals, in increasing order.
+  std::span<const std::uint64_t> up_states() const { return m_up_states; }
+
+  std::span<const std::uint64_t> down_states() const { return m_down_states; }
+
+  // Occupation word (see occupation_bits()) of the i-th product state.
+  std::uint64_t word(std::size_t i) const;
+
+  const CsrMatrix<Coeff>& up_hopping() const { return m_up_hopping; }
+
+  const CsrMatrix<Coeff>& down_hopping() const { return m_down_hopping; }
+
+  DiagonalStorage diagonal_storage() const { return m_storage; }
+
+  // Empty when the diagonal is computed on the fly.
+  std::span<const double> diagonal() const { return m_diagonal; }
+
+  // Density and density-density terms, on spin-blocked occupation words.
+  const DiagonalOperator& diagonal_operator() const {
+    return m_diagonal_operator;
+  }
+
+  // y = H x. The vectors must not overlap. Throws std::invalid_argument
+  // unless both have size() entries.
+  void apply(std::span<const Coeff> x, std::span<Coeff> y) const;
+
+ private:
+  struct Hopping {
+    std::size_t from;
+    std::size_t to;
+    Coeff coefficient;
+  };
+
+  static std::vector<std::uint64_t> spinless_states(
+      std::size_t orbitals, std::size_t particles);
+
+  static CsrMatrix<Coeff> hopping_matrix(
+      const std::vector<std::uint64_t>& states,
+      const std::vector<Hopping>& hoppings);
+
+  void compute_diagonal(
+      const std::vector<std::pair<std::vector<Operator>, Coeff>>& terms);
+
+  // Energies of diagonal_operator() on the states of up row u, with
+  // `words` as scratch space. Both spans have down_size() elements.
+  void row_energies(
+      std::size_t u, std::span<std::uint64_t> words,
+      std::span<double> energies) const;
+
+  std::size_t m_orbitals;
+  std::vector<std::uint64_t> m_up_states;
+  std::vector<std::uint64_t> m_down_states;
+  CsrMatrix<Coeff> m_up_hopping;
+  CsrMatrix<Coeff> m_down_hopping;
+  DiagonalOperator m_diagonal_operator;
+  DiagonalStorage m_storage;
+  std::vector<double> m_diagonal;
+};
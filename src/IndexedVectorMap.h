@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 template <class T>
@@ -30,6 +31,16 @@ class IndexedVectorMap {
     m_index_map[value] = m_elements.size() - 1;
   }
 
+  void insert(T&& value) {
+    m_elements.push_back(std::move(value));
+    m_index_map[m_elements.back()] = m_elements.size() - 1;
+  }
+
+  void reserve(std::size_t size) {
+    m_elements.reserve(size);
+    m_index_map.reserve(size);
+  }
+
   const T& operator[](std::size_t idx) const { return m_elements[idx]; }
 
   std::size_t index(const T& value) const { return m_index_map.at(value); }
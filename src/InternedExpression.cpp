@@ -0,0 +1,88 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "InternedExpression.h"
+
+InternedExpression::InternedExpression(
+    OperatorStringTable& table, const Expression& expression)
+    : m_table{&table} {
+  m_terms.reserve(expression.size());
+  for (const auto& [operators, coefficient] : expression.terms()) {
+    insert(m_table->intern(operators), coefficient);
+  }
+}
+
+InternedExpression& InternedExpression::operator+=(
+    const InternedExpression& other) {
+  LIBMB_ASSERT(m_table == other.m_table);
+  for (const auto& [id, coefficient] : other.m_terms) {
+    m_terms[id] += coefficient;
+  }
+  return *this;
+}
+
+InternedExpression InternedExpression::product(
+    const InternedExpression& other) const {
+  LIBMB_ASSERT(m_table == other.m_table);
+  InternedExpression result(*m_table);
+  for (const auto& [a, coefficient_a] : m_terms) {
+    for (const auto& [b, coefficient_b] : other.m_terms) {
+      result.insert(m_table->product(a, b), coefficient_a * coefficient_b);
+    }
+  }
+  return result;
+}
+
+InternedExpression InternedExpression::normal_ordered() const {
+  InternedExpression result(*m_table);
+  for (const auto& [id, coefficient] : m_terms) {
+    for (const auto& [ordered, factor] : m_table->normal_order(id)) {
+      result.insert(ordered, coefficient * factor);
+    }
+  }
+  return result;
+}
+
+Expression InternedExpression::expression() const {
+  Expression::ExpressionMap terms;
+  terms.reserve(m_terms.size());
+  for (const auto& [id, coefficient] : m_terms) {
+    auto operators = m_table->operators(id);
+    terms.emplace(
+        std::vector<Operator>(operators.begin(), operators.end()),
+        coefficient);
+  }
+  return Expression(std::move(terms));
+}
+
+// a b + sign b a, normal ordered, without building the two products.
+static InternedExpression ordered_sum(
+    const InternedExpression& a, const InternedExpression& b, double sign) {
+  LIBMB_ASSERT(&a.table() == &b.table());
+  OperatorStringTable& table = a.table();
+  InternedExpression result(table);
+  for (const auto& [x, coefficient_x] : a.terms()) {
+    for (const auto& [y, coefficient_y] : b.terms()) {
+      const auto coefficient = coefficient_x * coefficient_y;
+      const auto& xy = table.ordered_product(x, y);
+      for (const auto& [id, factor] : xy) {
+        result.insert(id, coefficient * factor);
+      }
+      const auto& yx = table.ordered_product(y, x);
+      for (const auto& [id, factor] : yx) {
+        result.insert(id, sign * coefficient * factor);
+      }
+    }
+  }
+  return result;
+}
+
+InternedExpression commute(
+    const InternedExpression& a, const InternedExpression& b) {
+  return ordered_sum(a, b, -1.0);
+}
+
+InternedExpression anticommute(
+    const InternedExpression& a, const InternedExpression& b) {
+  return ordered_sum(a, b, 1.0);
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <unordered_map>
+
+#include "Assert.h"
+#include "Expression.h"
+#include "OperatorStringTable.h"
+
+// An Expression whose operator strings are interned in an
+// OperatorStringTable, so that the terms are keyed by 32-bit IDs instead of
+// vectors. Products and normal ordering go through the memoized operations
+// of the table, which makes nested commutators of large expressions much
+// cheaper than with Expression.
+//
+// Expressions that are combined must share their table, which must outlive
+// them.
+class InternedExpression {
+ public:
+  using Id = OperatorStringTable::Id;
+  using Coeff = Term::CoeffType;
+  using TermMap = std::unordered_map<Id, Coeff>;
+
+  explicit InternedExpression(OperatorStringTable& table) : m_table{&table} {}
+
+  InternedExpression(OperatorStringTable& table, const Expression& expression);
+
+  OperatorStringTable& table() const { return *m_table; }
+
+  const TermMap& terms() const { return m_terms; }
+
+  TermMap& terms() { return m_terms; }
+
+  std::size_t size() const { return m_terms.size(); }
+
+  void insert(Id id, Coeff coefficient) { m_terms[id] += coefficient; }
+
+  void insert(const Term& term) {
+    insert(m_table->intern(term.operators()), term.coefficient());
+  }
+
+  InternedExpression& operator+=(const InternedExpression& other);
+
+  InternedExpression& operator*=(Coeff coefficient) {
+    for (auto& [id, value] : m_terms) {
+      value *= coefficient;
+    }
+    return *this;
+  }
+
+  bool operator==(const InternedExpression& other) const {
+    LIBMB_ASSERT(m_table == other.m_table);
+    return m_terms == other.m_terms;
+  }
+
+  bool operator!=(const InternedExpression& other) const {
+    return !(*this == other);
+  }
+
+  InternedExpression product(const InternedExpression& other) const;
+
+  InternedExpression normal_ordered() const;
+
+  // Back to operator strings.
+  Expression expression() const;
+
+ private:
+  OperatorStringTable* m_table;
+  TermMap m_terms;
+};
+
+// Normal-ordered [a, b] and {a, b}, like the functions of NormalOrderer.h.
+InternedExpression commute(
+    const InternedExpression& a, const InternedExpression& b);
+InternedExpression anticommute(
+    const InternedExpression& a, const InternedExpression& b);
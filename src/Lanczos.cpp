@@ -0,0 +1,113 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "Lanczos.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Assert.h"
+
+using Coeff = Term::CoeffType;
+
+// Lowest eigenvalue of the symmetric tridiagonal matrix with diagonal a and
+// off-diagonal b, by bisection on the Sturm sequence count.
+static double tridiagonal_lowest(
+    const std::vector<double>& a, const std::vector<double>& b) {
+  double low = a[0];
+  double high = a[0];
+  for (std::size_t i = 0; i < a.size(); i++) {
+    const double radius = (i > 0 ? std::abs(b[i - 1]) : 0.0) +
+                          (i < b.size() ? std::abs(b[i]) : 0.0);
+    low = std::min(low, a[i] - radius);
+    high = std::max(high, a[i] + radius);
+  }
+
+  // Number of eigenvalues below x.
+  auto count_below = [&](double x) {
+    std::size_t count = 0;
+    double d = 1.0;
+    for (std::size_t i = 0; i < a.size(); i++) {
+      const double off = i > 0 ? b[i - 1] * b[i - 1] : 0.0;
+      d = a[i] - x - (i > 0 ? off / d : 0.0);
+      if (d == 0.0) {
+        d = std::numeric_limits<double>::epsilon() * (std::abs(x) + 1.0);
+      }
+      if (d < 0.0) {
+        count++;
+      }
+    }
+    return count;
+  };
+
+  for (int step = 0; step < 200 && high - low > 0.0; step++) {
+    const double middle = low + (high - low) / 2;
+    if (middle <= low || middle >= high) {
+      break;
+    }
+    (count_below(middle) > 0 ? high : low) = middle;
+  }
+  return low + (high - low) / 2;
+}
+
+static double norm(std::span<const Coeff> x) {
+  double sum = 0.0;
+  for (const Coeff& value : x) {
+    sum += std::norm(value);
+  }
+  return std::sqrt(sum);
+}
+
+double lowest_eigenvalue(
+    std::size_t size, const LinearOperator& multiply, double tolerance,
+    std::size_t max_iterations) {
+  LIBMB_ASSERT(size > 0);
+  std::vector<Coeff> previous(size, 0.0);
+  std::vector<Coeff> current(size);
+  std::vector<Coeff> next(size);
+
+  // Pseudo-random entries in [-1, 1) from a 64-bit linear congruence.
+  std::uint64_t state = 0x853c49e6748fea9b;
+  for (Coeff& value : current) {
+    state = state * 6364136223846793005 + 1442695040888963407;
+    value = static_cast<double>(state >> 11) * 0x1p-52 - 1.0;
+  }
+  const double start = norm(current);
+  for (Coeff& value : current) {
+    value /= start;
+  }
+
+  std::vector<double> alpha;
+  std::vector<double> beta;
+  double energy = std::numeric_limits<double>::infinity();
+  for (std::size_t k = 0; k < std::min(size, max_iterations); k++) {
+    multiply(current, next);
+    Coeff overlap = 0.0;
+    for (std::size_t i = 0; i < size; i++) {
+      overlap += std::conj(current[i]) * next[i];
+    }
+    alpha.push_back(overlap.real());
+    const double b = beta.empty() ? 0.0 : beta.back();
+    for (std::size_t i = 0; i < size; i++) {
+      next[i] -= alpha.back() * current[i] + b * previous[i];
+    }
+
+    const double last = energy;
+    energy = tridiagonal_lowest(alpha, beta);
+    const double residual = norm(next);
+    if (std::abs(energy - last) < tolerance ||
+        residual < tolerance * std::max(1.0, std::abs(energy))) {
+      break;
+    }
+
+    beta.push_back(residual);
+    for (std::size_t i = 0; i < size; i++) {
+      previous[i] = current[i];
+      current[i] = next[i] / residual;
+    }
+  }
+  return energy;
+}
@@ -0,0 +1,24 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <functional>
+#include <span>
+
+#include "Term.h"
+
+using LinearOperator = std::function<void(
+    std::span<const Term::CoeffType>, std::span<Term::CoeffType>)>;
+
+// Lowest eigenvalue of a Hermitian operator of the given dimension, by the
+// Lanczos method. Only three vectors are kept, without reorthogonalization,
+// which is enough for the ground state. Stops when the lowest Ritz value
+// changes by less than `tolerance` in an iteration, or when the Krylov
+// space is exhausted, in which case the result is exact.
+//
+// The start vector is a fixed pseudo-random one, so that the result does
+// not depend on the run and has an overlap with any symmetry sector.
+double lowest_eigenvalue(
+    std::size_t size, const LinearOperator& multiply,
+    double tolerance = 1e-12, std::size_t max_iterations = 1000);
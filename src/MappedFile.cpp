@@ -0,0 +1,40 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+std::optional<MappedFile> MappedFile::open(const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return std::nullopt;
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+    ::close(fd);
+    return std::nullopt;
+  }
+
+  const std::size_t size = static_cast<std::size_t>(st.st_size);
+  void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping keeps its own reference to the file.
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return std::nullopt;
+  }
+
+  return MappedFile(static_cast<const std::byte*>(data), size);
+}
+
+void MappedFile::unmap() {
+  if (m_data != nullptr) {
+    ::munmap(const_cast<std::byte*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+  }
+}
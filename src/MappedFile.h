@@ -0,0 +1,48 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+
+// Read-only memory mapping of a whole file. The mapping is shared between
+// all processes that open the same file, so large cached objects are only
+// kept once in the page cache of the node.
+class MappedFile {
+ public:
+  static std::optional<MappedFile> open(const std::string& path);
+
+  MappedFile(MappedFile&& other) noexcept
+      : m_data(std::exchange(other.m_data, nullptr)),
+        m_size(std::exchange(other.m_size, 0)) {}
+
+  MappedFile& operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+      unmap();
+      m_data = std::exchange(other.m_data, nullptr);
+      m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() { unmap(); }
+
+  const std::byte* data() const { return m_data; }
+
+  std::size_t size() const { return m_size; }
+
+ private:
+  MappedFile(const std::byte* data, std::size_t size)
+      : m_data(data), m_size(size) {}
+
+  void unmap();
+
+  const std::byte* m_data = nullptr;
+  std::size_t m_size = 0;
+};
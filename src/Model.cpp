@@ -2,3 +2,59 @@
 // SPDX-License-Identifier: BSD-2-Clause
 
 #include "Model.h"
+
+#include <algorithm>
+
+static bool is_fermionic(const Basis& basis) {
+  return std::all_of(
+      basis.elements().begin(), basis.elements().end(),
+      [](const BasisElement& element) {
+        return std::all_of(
+            element.begin(), element.end(), [](const Operator& op) {
+              return op.is_fermion() && op.type() == Operator::Type::Creation;
+            });
+      });
+}
+
+DiagonalOperator Model::split_diagonal(
+    Expression& hamiltonian, const Basis& basis) {
+  if (!is_fermionic(basis)) {
+    return DiagonalOperator(basis.orbitals());
+  }
+  return DiagonalOperator::split(hamiltonian, basis.orbitals());
+}
+
+std::vector<double> Model::row_costs(
+    const Expression& hamiltonian, const Basis& basis,
+    TaskScheduler& scheduler) {
+  std::vector<double> result(basis.size(), 1.0);
+  const bool fermionic_terms = std::all_of(
+      hamiltonian.terms().begin(), hamiltonian.terms().end(),
+      [](const auto& item) {
+        return std::all_of(
+            item.first.begin(), item.first.end(), [](const Operator& op) {
+              return op.is_fermion() && op.orbital() < 32;
+            });
+      });
+  if (!fermionic_terms || !is_fermionic(basis)) {
+    return result;
+  }
+
+  const RowCostModel model(hamiltonian);
+  scheduler.parallel_for(0, result.size(), 4096, [&](std::size_t i) {
+    result[i] = model(occupation_bits(basis.element(i)));
+  });
+  return result;
+}
+
+void Model::add_diagonal(
+    const DiagonalOperator& diagonal, const BasisElement& element,
+    Expression::ExpressionMap& product) {
+  if (diagonal.empty()) {
+    return;
+  }
+  const double energy = diagonal(occupation_bits(element));
+  if (std::abs(energy) > 0.0) {
+    product[element] += energy;
+  }
+}
@@ -3,8 +3,21 @@
 
 #pragma once
 
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "Basis.h"
+#include "DiagonalOperator.h"
+#include "GrandCanonicalBuilder.h"
+#include "HubbardEngine.h"
 #include "NormalOrderer.h"
+#include "ReachableBasis.h"
+#include "RowSchedule.h"
+#include "SymmetricBasis.h"
+#include "TaskScheduler.h"
 
 class Model {
  public:
@@ -15,28 +28,184 @@ class Model {
   Model(Model&& other) = delete;
   Model& operator=(Model&& other) = delete;
 
+  // How the rows computed by the threads are written into the matrix.
+  enum class Assembly {
+    // Every element as soon as it is computed, under a lock. The insertion
+    // order, and so the layout of hashed matrices, varies between runs.
+    Unordered,
+    // Rows are computed in parallel into buffers owned by the threads and
+    // written in increasing row (then column) order. The result is bitwise
+    // identical for any number of threads.
+    Deterministic,
+  };
+
+  // mat(i, j) = <j|H|i>, with the rows computed on the threads of
+  // `scheduler`.
   template <typename SpMat>
-  void compute_matrix_elements(const Basis& basis, SpMat& mat) const {
-    const Expression& hamilt = hamiltonian();
-#pragma omp parallel for schedule(dynamic)
-    for (const BasisElement& basis_element : basis.elements()) {
-      std::size_t basis_index = basis.index(basis_element);
+  void compute_matrix_elements(
+      const Basis& basis, SpMat& mat,
+      Assembly assembly = Assembly::Unordered,
+      TaskScheduler& scheduler = TaskScheduler::current()) const {
+    Expression hamilt = hamiltonian();
+    const DiagonalOperator diagonal = split_diagonal(hamilt, basis);
+    auto row = [&](std::size_t basis_index, MatrixRow& result) {
+      const BasisElement& basis_element = basis.element(basis_index);
       Expression::ExpressionMap product =
           NormalOrderer(hamilt.product(basis_element)).terms();
-      std::erase_if(product, [&](const auto& item) {
-        return !basis.contains(item.first);
-      });
+      add_diagonal(diagonal, basis_element, product);
       for (const auto& [term, coeff] : product) {
-        std::size_t term_index = basis.index(term);
-#pragma omp critical
-        mat(basis_index, term_index) = coeff;
+        if (basis.contains(term)) {
+          result.emplace_back(basis.index(term), coeff);
+        }
       }
-    }
+    };
+    assemble(
+        row, row_costs(hamilt, basis, scheduler), mat, assembly, scheduler);
+  }
+
+  // Hamiltonian block of one symmetry sector, in the basis of symmetrized
+  // states. The group must commute with the Hamiltonian.
+  template <typename SpMat>
+  void compute_matrix_elements(
+      const SymmetricBasis& basis, SpMat& mat,
+      Assembly assembly = Assembly::Unordered,
+      TaskScheduler& scheduler = TaskScheduler::current()) const {
+    Expression hamilt = hamiltonian();
+    const DiagonalOperator diagonal = split_diagonal(hamilt, basis);
+    auto row = [&](std::size_t basis_index, MatrixRow& result) {
+      const BasisElement& basis_element = basis.element(basis_index);
+      Expression::ExpressionMap product =
+          NormalOrderer(hamilt.product(basis_element)).terms();
+      add_diagonal(diagonal, basis_element, product);
+      // <t~|H|r~> = sum_s <t~|s> <s|H|r> / <r~|r>, and several s can belong
+      // to the same orbit.
+      std::unordered_map<std::size_t, Term::CoeffType> sums;
+      for (const auto& [term, coeff] : product) {
+        auto target = basis.find(term);
+        if (target.has_value()) {
+          sums[target->first] +=
+              coeff * target->second / basis.overlap(basis_index);
+        }
+      }
+      result.assign(sums.begin(), sums.end());
+    };
+    assemble(
+        row, row_costs(hamilt, basis, scheduler), mat, assembly, scheduler);
+  }
+
+  // Basis of the states connected to the seeds by the Hamiltonian.
+  ReachableBasis reachable_basis(
+      std::size_t n, const std::vector<BasisElement>& seeds) const {
+    return ReachableBasis(n, hamiltonian(), seeds);
+  }
+
+  // Blocks of all the particle number and spin sectors with a number of
+  // electrons in `particles`, built together. See GrandCanonicalBuilder.
+  std::vector<SectorBlock> sector_blocks(
+      std::size_t n, const std::vector<std::size_t>& particles,
+      std::optional<int> total_spin = std::nullopt) const {
+    return GrandCanonicalBuilder(n, hamiltonian())
+        .build(particles, total_spin);
+  }
+
+  // Matrix-free Hamiltonian of the sector with the given number of up and
+  // down electrons on n orbitals, for models whose hopping conserves spin.
+  HubbardEngine hubbard_engine(
+      std::size_t n, std::size_t up_particles,
+      std::size_t down_particles,
+      HubbardEngine::DiagonalStorage storage =
+          HubbardEngine::DiagonalStorage::Stored) const {
+    return HubbardEngine(
+        n, up_particles, down_particles, hamiltonian(), storage);
   }
 
  protected:
   Model() = default;
 
  private:
+  using MatrixRow = std::vector<std::pair<std::size_t, Term::CoeffType>>;
+
+  // Rows per step of the deterministic assembly, which bounds the memory of
+  // the buffers.
+  static constexpr std::size_t assembly_block = 1 << 14;
+
+  // Writes mat(i, j) = c for the (j, c) that row(i, result) appends to
+  // result, for every row i. Chunks of rows of about equal estimated cost
+  // (one cost per row) run as tasks of the scheduler.
+  template <typename SpMat, typename Row>
+  static void assemble(
+      const Row& row, std::span<const double> costs, SpMat& mat,
+      Assembly assembly, TaskScheduler& scheduler) {
+    const std::size_t rows = costs.size();
+    if (assembly == Assembly::Unordered) {
+      const RowSchedule schedule(
+          costs, RowSchedule::default_chunks(scheduler));
+      std::mutex mutex;
+      TaskGroup group(scheduler);
+      for (std::size_t k = 0; k < schedule.size(); k++) {
+        group.run([&, k]() {
+          const auto [first, last] = schedule.chunk(k);
+          MatrixRow result;
+          for (std::size_t i = first; i < last; i++) {
+            result.clear();
+            row(i, result);
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& [j, coeff] : result) {
+              mat(i, j) = coeff;
+            }
+          }
+        });
+      }
+      group.wait();
+      return;
+    }
+
+    // A row only depends on its index, not on the thread that computes it,
+    // so the scheduling of the block does not matter.
+    std::vector<MatrixRow> buffers(std::min(rows, assembly_block));
+    for (std::size_t offset = 0; offset < rows; offset += assembly_block) {
+      const std::size_t count = std::min(assembly_block, rows - offset);
+      const RowSchedule schedule(
+          costs.subspan(offset, count), RowSchedule::default_chunks(scheduler));
+      TaskGroup group(scheduler);
+      for (std::size_t k = 0; k < schedule.size(); k++) {
+        group.run([&, k]() {
+          const auto [first, last] = schedule.chunk(k);
+          for (std::size_t i = first; i < last; i++) {
+            buffers[i].clear();
+            row(offset + i, buffers[i]);
+            std::sort(
+                buffers[i].begin(), buffers[i].end(),
+                [](const auto& a, const auto& b) {
+                  return a.first < b.first;
+                });
+          }
+        });
+      }
+      group.wait();
+      for (std::size_t i = 0; i < count; i++) {
+        for (const auto& [j, coeff] : buffers[i]) {
+          mat(offset + i, j) = coeff;
+        }
+      }
+    }
+  }
+
+  // Estimated cost of every row, see RowCostModel. The costs are uniform
+  // unless the basis is fermionic.
+  static std::vector<double> row_costs(
+      const Expression& hamiltonian, const Basis& basis,
+      TaskScheduler& scheduler);
+
+  // Moves the density terms out of the Hamiltonian when the basis states
+  // are fermionic, so that they are evaluated on the occupation words
+  // instead of being multiplied and normal ordered for every state.
+  static DiagonalOperator split_diagonal(
+      Expression& hamiltonian, const Basis& basis);
+
+  static void add_diagonal(
+      const DiagonalOperator& diagonal, const BasisElement& element,
+      Expression::ExpressionMap& product);
+
   virtual Expression hamiltonian() const = 0;
 };
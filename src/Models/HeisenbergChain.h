@@ -1,6 +1,7 @@
 // Copyright (c) 2024 Matheus Sousa
 // SPDX-License-Identifier: BSD-2-Clause
 
+#include "ExpressionTemplates.h"
 #include "Model.h"
 
 class HeisenbergChain : public Model {
@@ -17,13 +18,13 @@ class HeisenbergChain : public Model {
     Expression result;
 
     for (std::size_t i = 0; i < m_size; i++) {
-      result += -m_h * spin_z(i);
+      result += -m_h * lazy(spin_z(i));
     }
 
     for (std::size_t i = 0; i < m_size; i++) {
-      result += m_J * spin_x(i) * spin_x((i + 1) % m_size);
-      result += m_J * spin_y(i) * spin_y((i + 1) % m_size);
-      result += m_J * spin_z(i) * spin_z((i + 1) % m_size);
+      result += m_J * lazy(spin_x(i)) * lazy(spin_x((i + 1) % m_size));
+      result += m_J * lazy(spin_y(i)) * lazy(spin_y((i + 1) % m_size));
+      result += m_J * lazy(spin_z(i)) * lazy(spin_z((i + 1) % m_size));
     }
     return result;
   }
@@ -0,0 +1,27 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <utility>
+
+#include "Fcidump.h"
+#include "Model.h"
+
+// A molecule given by its integrals, usually read with load_fcidump().
+class MolecularModel : public Model {
+ public:
+  explicit MolecularModel(Fcidump integrals)
+      : m_integrals(std::move(integrals)) {}
+
+  ~MolecularModel() override {}
+
+  const Fcidump& integrals() const { return m_integrals; }
+
+ private:
+  Expression hamiltonian() const override {
+    return molecular_hamiltonian(m_integrals);
+  }
+
+  Fcidump m_integrals;
+};
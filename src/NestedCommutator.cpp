@@ -0,0 +1,65 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "NestedCommutator.h"
+
+#include <algorithm>
+
+#include "NormalOrderer.h"
+#include "TaskScheduler.h"
+
+Expression parallel_commute(
+    const Expression& s, const Expression& x, TaskScheduler& scheduler) {
+  const std::size_t chunks = std::min(
+      x.size(), Expression::product_chunks(s.size() * x.size(), scheduler));
+  if (chunks <= 1) {
+    return commute(s, x);
+  }
+
+  std::vector<Expression> parts(chunks);
+  for (Expression& part : parts) {
+    part.set_tolerance(x.tolerance());
+  }
+  std::size_t k = 0;
+  for (const auto& [operators, coefficient] : x.terms()) {
+    parts[k++ % chunks] += Term(coefficient, operators);
+  }
+  // The parts run as tasks of the scheduler, so the products inside them
+  // stay on it too.
+  scheduler.parallel_for(0, chunks, 1, [&](std::size_t i) {
+    parts[i] = commute(s, parts[i]);
+  });
+  return sum(std::move(parts), scheduler);
+}
+
+std::vector<Expression> nested_commutators(
+    const Expression& s, const Expression& h, std::size_t order,
+    TaskScheduler& scheduler) {
+  std::vector<Expression> result;
+  result.reserve(order + 1);
+  result.push_back(h);
+  for (std::size_t k = 1; k <= order; k++) {
+    Expression next = parallel_commute(s, result.back(), scheduler)
+                          .product(1.0 / static_cast<double>(k));
+    if (next.size() == 0) {
+      // An order that was truncated away still reports what it dropped.
+      if (next.discarded() > 0.0) {
+        result.push_back(std::move(next));
+      }
+      break;
+    }
+    result.push_back(std::move(next));
+  }
+  return result;
+}
+
+Expression bch_transform(
+    const Expression& s, const Expression& h, std::size_t order,
+    TaskScheduler& scheduler) {
+  Expression result;
+  result.set_tolerance(std::max(s.tolerance(), h.tolerance()));
+  for (Expression& term : nested_commutators(s, h, order, scheduler)) {
+    result += std::move(term);
+  }
+  return result;
+}
@@ -0,0 +1,44 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Expression.h"
+#include "TaskScheduler.h"
+
+// Series of nested commutators, as in the Baker-Campbell-Hausdorff
+// expansion
+//
+//   e^S H e^-S = H + [S, H] + 1/2! [S, [S, H]] + 1/3! [S, [S, [S, H]]] + ...
+//
+// of similarity transformations (Schrieffer-Wolff, coupled cluster) and of
+// the Heisenberg picture, A(t) = e^{iHt} A e^{-iHt} with S = iHt.
+//
+// Every order is the commutator of S with the previous one, so each order
+// only multiplies S with the last result instead of the full nested
+// product. The terms of an order are split over the threads of the
+// scheduler, and the tolerances of S and H (see Expression::set_tolerance())
+// apply at every order.
+
+// [s, x], with the terms of x split into parts that are commuted in
+// parallel and summed.
+Expression parallel_commute(
+    const Expression& s, const Expression& x,
+    TaskScheduler& scheduler = TaskScheduler::current());
+
+// ad_s^k(h) / k! for k = 0, ..., order: h, [s, h], [s, [s, h]] / 2, ...
+// Stops early, with fewer elements, when an order vanishes. An order whose
+// terms all fell below the tolerance is kept, empty, as the last element,
+// so that its discarded() weight is not lost.
+std::vector<Expression> nested_commutators(
+    const Expression& s, const Expression& h, std::size_t order,
+    TaskScheduler& scheduler = TaskScheduler::current());
+
+// e^s h e^-s, up to the given order in s. discarded() of the result adds up
+// the weight dropped at all orders.
+Expression bch_transform(
+    const Expression& s, const Expression& h, std::size_t order,
+    TaskScheduler& scheduler = TaskScheduler::current());
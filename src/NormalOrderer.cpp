@@ -3,9 +3,12 @@
 
 #include "NormalOrderer.h"
 
+#include <algorithm>
 #include <deque>
 #include <vector>
 
+#include "TaskScheduler.h"
+
 constexpr Term::CoeffType evaluate_parity(
     Term::CoeffType coefficient, std::size_t phase) {
   return phase % 2 == 0 ? coefficient : -coefficient;
@@ -22,35 +25,104 @@ NormalOrderer::NormalOrderer(const std::vector<Term>& terms) {
 }
 
 NormalOrderer::NormalOrderer(const Expression& expression) {
+  insert(expression);
+}
+
+NormalOrderer::NormalOrderer(const std::vector<Expression>& expressions) {
+  for (const Expression& expression : expressions) {
+    m_tolerance = std::max(m_tolerance, expression.tolerance());
+  }
+  for (const Expression& expression : expressions) {
+    insert(expression);
+  }
+}
+
+NormalOrderer::NormalOrderer(Term&& term) {
+  normal_order(std::move(term.operators()), term.coefficient());
+}
+
+NormalOrderer::NormalOrderer(std::vector<Term>&& terms) {
+  for (Term& term : terms) {
+    normal_order(std::move(term.operators()), term.coefficient());
+  }
+}
+
+NormalOrderer::NormalOrderer(Expression&& expression) {
+  insert(std::move(expression));
+}
+
+NormalOrderer::NormalOrderer(std::vector<Expression>&& expressions) {
+  for (const Expression& expression : expressions) {
+    m_tolerance = std::max(m_tolerance, expression.tolerance());
+  }
+  for (Expression& expression : expressions) {
+    insert(std::move(expression));
+  }
+}
+
+void NormalOrderer::insert(const Expression& expression) {
+  m_tolerance = std::max(m_tolerance, expression.tolerance());
+  m_discarded += expression.discarded();
   for (const auto& [operators, coeff] : expression.terms()) {
     normal_order(operators, coeff);
   }
 }
 
-NormalOrderer::NormalOrderer(const std::vector<Expression>& expressions) {
-  for (const Expression& expression : expressions) {
-    for (const auto& [operators, coeff] : expression.terms()) {
-      normal_order(operators, coeff);
-    }
+void NormalOrderer::insert(Expression&& expression) {
+  m_tolerance = std::max(m_tolerance, expression.tolerance());
+  m_discarded += expression.discarded();
+  auto& terms = expression.terms();
+  while (!terms.empty()) {
+    auto node = terms.extract(terms.begin());
+    normal_order(std::move(node.key()), node.mapped());
+  }
+}
+
+Expression NormalOrderer::expression() const& {
+  return NormalOrderer(*this).expression();
+}
+
+Expression NormalOrderer::expression() && {
+  Expression result(std::move(m_terms_map));
+  result.m_tolerance = m_tolerance;
+  result.m_discarded = m_discarded;
+  return result;
+}
+
+void NormalOrderer::accumulate(
+    std::vector<Operator>&& operators, Term::CoeffType value) {
+  auto it = m_terms_map.try_emplace(std::move(operators)).first;
+  it->second += value;
+  if (m_tolerance > 0.0 && std::abs(it->second) < m_tolerance) {
+    m_discarded += std::abs(it->second);
+    m_terms_map.erase(it);
   }
 }
 
 void NormalOrderer::normal_order(
-    const std::vector<Operator>& operators, Term::CoeffType coefficient) {
+    std::vector<Operator> operators, Term::CoeffType coefficient) {
+  // Every term of the expansion has the magnitude of `coefficient`, so a
+  // negligible term is dropped before it branches.
+  if (m_tolerance > 0.0 && std::abs(coefficient) < m_tolerance) {
+    m_discarded += std::abs(coefficient);
+    return;
+  }
   std::deque<OperatorsPhasePair> queue;
-  queue.emplace_back(operators, 0);
+  queue.emplace_back(std::move(operators), 0);
   while (!queue.empty()) {
     auto [prev_operators, prev_phase] = std::move(queue.back());
     queue.pop_back();
 
     if (prev_operators.size() < 2) {
-      m_terms_map[prev_operators] += evaluate_parity(coefficient, prev_phase);
+      accumulate(
+          std::move(prev_operators), evaluate_parity(coefficient, prev_phase));
       continue;
     }
 
     auto [new_operators, new_phase] =
-        sort_operators(prev_operators, prev_phase, queue);
-    m_terms_map[new_operators] += evaluate_parity(coefficient, new_phase);
+        sort_operators(std::move(prev_operators), prev_phase, queue);
+    accumulate(
+        std::move(new_operators), evaluate_parity(coefficient, new_phase));
   }
 }
 
@@ -85,30 +157,81 @@ NormalOrderer::OperatorsPhasePair NormalOrderer::sort_operators(
       }
     }
   }
-  return OperatorsPhasePair{operators, phase};
+  return OperatorsPhasePair{std::move(operators), phase};
+}
+
+Expression normal_ordered_product(
+    const Expression& a, const Expression& b, TaskScheduler& scheduler) {
+  std::vector<const Expression::ExpressionMap::value_type*> outer;
+  outer.reserve(a.size());
+  for (const auto& term : a.terms()) {
+    outer.push_back(&term);
+  }
+  const std::size_t chunks =
+      Expression::product_chunks(a.size() * b.size(), scheduler);
+  std::vector<Expression> parts(chunks);
+  auto run_chunk = [&](std::size_t k) {
+    NormalOrderer orderer(std::max(a.tolerance(), b.tolerance()));
+    std::vector<Operator> buffer;
+    const std::size_t first = k * outer.size() / chunks;
+    const std::size_t last = (k + 1) * outer.size() / chunks;
+    for (std::size_t i = first; i < last; i++) {
+      const auto& [operators_a, coefficient_a] = *outer[i];
+      for (const auto& [operators_b, coefficient_b] : b.terms()) {
+        buffer.assign(operators_a.begin(), operators_a.end());
+        buffer.insert(buffer.end(), operators_b.begin(), operators_b.end());
+        orderer.insert(buffer, coefficient_a * coefficient_b);
+      }
+    }
+    parts[k] = std::move(orderer).expression();
+  };
+  if (chunks == 1) {
+    run_chunk(0);
+  } else {
+    scheduler.parallel_for(0, chunks, 1, run_chunk);
+  }
+  return sum(std::move(parts), scheduler);
+}
+
+Expression normal_ordered_product(const Expression& a, const Expression& b) {
+  return normal_ordered_product(a, b, TaskScheduler::current());
+}
+
+// The products are built in a vector that the NormalOrderer consumes, rather
+// than in an initializer list, whose elements can only be copied.
+template <typename T>
+static std::vector<T> pair_of(T&& first, T&& second) {
+  std::vector<T> result;
+  result.reserve(2);
+  result.push_back(std::move(first));
+  result.push_back(std::move(second));
+  return result;
 }
 
 Expression commute(const Term& term1, const Term& term2) {
-  return NormalOrderer({term1.product(term2), term2.product(term1).negate()})
+  return NormalOrderer(pair_of(
+                           term1.product(term2),
+                           term2.product(term1).negate()))
       .expression();
 }
 
 Expression commute(
     const Expression& expression1, const Expression& expression2) {
-  return NormalOrderer({expression1.product(expression2),
-                        expression2.product(expression1).negate()})
+  return NormalOrderer(pair_of(
+                           expression1.product(expression2),
+                           expression2.product(expression1).negate()))
       .expression();
 }
 
 Expression anticommute(const Term& term1, const Term& term2) {
-  return NormalOrderer({term1.product(term2), term2.product(term1)})
+  return NormalOrderer(pair_of(term1.product(term2), term2.product(term1)))
       .expression();
 }
 
 Expression anticommute(
     const Expression& expression1, const Expression& expression2) {
-  return NormalOrderer({expression1.product(expression2),
-                        expression2.product(expression1)})
+  return NormalOrderer(pair_of(
+                           expression1.product(expression2),
+                           expression2.product(expression1)))
       .expression();
-  ;
 }
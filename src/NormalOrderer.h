@@ -15,6 +15,14 @@ class NormalOrderer {
  public:
   using OperatorsPhasePair = std::pair<std::vector<Operator>, std::size_t>;
 
+  NormalOrderer() = default;
+
+  // Terms below `tolerance` are dropped, see Expression::set_tolerance().
+  // Terms whose coefficient is already below it are not expanded at all.
+  // The constructors that take Expressions use the largest of their
+  // tolerances, and carry over what they discarded.
+  explicit NormalOrderer(double tolerance) : m_tolerance{tolerance} {}
+
   NormalOrderer(const Term& term);
 
   NormalOrderer(const std::vector<Term>& terms);
@@ -23,19 +31,60 @@ class NormalOrderer {
 
   NormalOrderer(const std::vector<Expression>& expressions);
 
-  const Expression::ExpressionMap& terms() const { return m_terms_map; }
+  // The operator strings of temporaries are reordered in place instead of
+  // being copied first.
+  NormalOrderer(Term&& term);
+
+  NormalOrderer(std::vector<Term>&& terms);
+
+  NormalOrderer(Expression&& expression);
+
+  NormalOrderer(std::vector<Expression>&& expressions);
+
+  // Adds the normal-ordered expansion of coefficient * operators.
+  void insert(std::vector<Operator> operators, Term::CoeffType coefficient) {
+    normal_order(std::move(operators), coefficient);
+  }
+
+  void insert(const Expression& expression);
+
+  void insert(Expression&& expression);
 
-  Expression expression() const { return Expression(m_terms_map); }
+  double tolerance() const { return m_tolerance; }
+
+  double discarded() const { return m_discarded; }
+
+  const Expression::ExpressionMap& terms() const& { return m_terms_map; }
+
+  Expression::ExpressionMap terms() && { return std::move(m_terms_map); }
+
+  // With the tolerance and the discarded weight of the orderer.
+  Expression expression() const&;
+
+  Expression expression() &&;
 
  private:
-  void normal_order(const std::vector<Operator>&, Term::CoeffType);
+  void normal_order(std::vector<Operator>, Term::CoeffType);
+
+  void accumulate(std::vector<Operator>&& operators, Term::CoeffType value);
 
   OperatorsPhasePair sort_operators(
       std::vector<Operator>, std::size_t, std::deque<OperatorsPhasePair>&);
 
   Expression::ExpressionMap m_terms_map;
+  double m_tolerance = 0.0;
+  double m_discarded = 0.0;
 };
 
+// NormalOrderer(a * b), without building a * b: every product of a pair of
+// terms is normal ordered as soon as it is formed. Large products run in
+// parallel on `scheduler` like Expression::product().
+Expression normal_ordered_product(
+    const Expression& a, const Expression& b, TaskScheduler& scheduler);
+
+// The normal ordered product on TaskScheduler::current().
+Expression normal_ordered_product(const Expression& a, const Expression& b);
+
 Expression commute(const Term& term1, const Term& term2);
 Expression commute(
     const Expression& expression1, const Expression& expression2);
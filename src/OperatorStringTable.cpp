@@ -0,0 +1,119 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "OperatorStringTable.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "Assert.h"
+#include "NormalOrderer.h"
+
+// Same as std::hash<std::vector<Operator>>, without needing a vector.
+static std::size_t hash_operators(std::span<const Operator> operators) {
+  std::size_t seed = 0;
+  for (Operator op : operators) {
+    seed ^= std::hash<Operator>{}(op) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  }
+  return seed;
+}
+
+OperatorStringTable::OperatorStringTable() : m_offsets{0} {
+  intern({});
+}
+
+std::optional<OperatorStringTable::Id> OperatorStringTable::find(
+    std::span<const Operator> operators) const {
+  auto [first, last] = m_index.equal_range(hash_operators(operators));
+  for (auto it = first; it != last; ++it) {
+    if (std::ranges::equal(this->operators(it->second), operators)) {
+      return it->second;
+    }
+  }
+  return std::nullopt;
+}
+
+OperatorStringTable::Id OperatorStringTable::intern(
+    std::span<const Operator> operators) {
+  if (auto id = find(operators)) {
+    return *id;
+  }
+  LIBMB_ASSERT(size() < std::numeric_limits<Id>::max());
+  const auto id = static_cast<Id>(size());
+  m_operators.insert(m_operators.end(), operators.begin(), operators.end());
+  m_offsets.push_back(m_operators.size());
+  m_index.emplace(hash_operators(operators), id);
+  return id;
+}
+
+OperatorStringTable::Id OperatorStringTable::product(Id a, Id b) {
+  if (a == empty_id) {
+    return b;
+  }
+  if (b == empty_id) {
+    return a;
+  }
+  const std::uint64_t key = pair_key(a, b);
+  auto it = m_products.find(key);
+  if (it != m_products.end()) {
+    return it->second;
+  }
+
+  // The operators of `a` and `b` may move when the product is added, so it
+  // is built in a buffer first.
+  std::vector<Operator> buffer;
+  buffer.reserve(operators(a).size() + operators(b).size());
+  buffer.assign(operators(a).begin(), operators(a).end());
+  buffer.insert(buffer.end(), operators(b).begin(), operators(b).end());
+  const Id id = intern(buffer);
+  m_products.emplace(key, id);
+  return id;
+}
+
+const OperatorStringTable::Expansion& OperatorStringTable::normal_order(
+    Id id) {
+  auto it = m_normal_orders.find(id);
+  if (it != m_normal_orders.end()) {
+    return it->second;
+  }
+
+  auto span = operators(id);
+  Expansion expansion =
+      expand(std::vector<Operator>(span.begin(), span.end()));
+  // Node-based, so the reference survives later insertions.
+  return m_normal_orders.emplace(id, std::move(expansion)).first->second;
+}
+
+const OperatorStringTable::Expansion& OperatorStringTable::ordered_product(
+    Id a, Id b) {
+  const std::uint64_t key = pair_key(a, b);
+  auto it = m_ordered_products.find(key);
+  if (it != m_ordered_products.end()) {
+    return it->second;
+  }
+
+  std::vector<Operator> buffer;
+  buffer.reserve(operators(a).size() + operators(b).size());
+  buffer.assign(operators(a).begin(), operators(a).end());
+  buffer.insert(buffer.end(), operators(b).begin(), operators(b).end());
+  Expansion expansion = expand(std::move(buffer));
+  return m_ordered_products.emplace(key, std::move(expansion)).first->second;
+}
+
+void OperatorStringTable::clear_memo() {
+  // Swapped with empty maps, since clear() keeps the buckets allocated.
+  std::unordered_map<std::uint64_t, Id>().swap(m_products);
+  std::unordered_map<Id, Expansion>().swap(m_normal_orders);
+  std::unordered_map<std::uint64_t, Expansion>().swap(m_ordered_products);
+}
+
+OperatorStringTable::Expansion OperatorStringTable::expand(
+    std::vector<Operator> operators) {
+  auto terms = NormalOrderer(Term(1.0, std::move(operators))).terms();
+  Expansion expansion;
+  expansion.reserve(terms.size());
+  for (const auto& [ordered, coefficient] : terms) {
+    expansion.emplace_back(intern(ordered), coefficient);
+  }
+  return expansion;
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Operator.h"
+#include "Term.h"
+
+// Interning table for operator strings. Every distinct string gets a 32-bit
+// ID, so that expressions built in the same table can be keyed by integers
+// (see InternedExpression) and compare and hash in O(1) per term. The
+// operators of all strings live in one contiguous buffer.
+//
+// The products and normal orderings of strings are memoized by ID, which
+// pays off when the same strings are multiplied many times, as in nested
+// commutators. The memo is never evicted on its own: a commutator of
+// expressions with n and m terms adds up to 2 n m ordered products, each
+// holding its whole expansion, so long computations should call
+// clear_memo() between stages that do not share strings.
+//
+// A table is not thread safe: every thread needs its own.
+class OperatorStringTable {
+ public:
+  using Id = std::uint32_t;
+  using Coeff = Term::CoeffType;
+  using Expansion = std::vector<std::pair<Id, Coeff>>;
+
+  // The empty string is interned by the constructor with ID 0.
+  static constexpr Id empty_id = 0;
+
+  OperatorStringTable();
+
+  // The ID of `operators`, adding them to the table if they are new.
+  Id intern(std::span<const Operator> operators);
+
+  // The ID of `operators` if they are in the table.
+  std::optional<Id> find(std::span<const Operator> operators) const;
+
+  std::span<const Operator> operators(Id id) const {
+    return std::span<const Operator>(m_operators)
+        .subspan(m_offsets[id], m_offsets[id + 1] - m_offsets[id]);
+  }
+
+  std::size_t size() const { return m_offsets.size() - 1; }
+
+  // The ID of the concatenation of the strings `a` and `b`.
+  Id product(Id a, Id b);
+
+  // Normal-ordered expansion of the string `id`, with unit coefficient, as
+  // (ID, coefficient) pairs. The reference stays valid as long as the
+  // table.
+  const Expansion& normal_order(Id id);
+
+  // normal_order(product(a, b)), without interning the product itself,
+  // which is usually not normal ordered and not needed again.
+  const Expansion& ordered_product(Id a, Id b);
+
+  // The number of memoized products, normal orderings and ordered products.
+  std::size_t memo_size() const {
+    return m_products.size() + m_normal_orders.size() +
+           m_ordered_products.size();
+  }
+
+  // Frees the memoized results, and invalidates the references returned by
+  // normal_order() and ordered_product(). The interned strings are kept, so
+  // IDs stay valid; they are recomputed on demand.
+  void clear_memo();
+
+ private:
+  std::vector<Operator> m_operators;
+  std::vector<std::size_t> m_offsets;
+  // Hash of a string to the IDs with that hash.
+  std::unordered_multimap<std::size_t, Id> m_index;
+  std::unordered_map<std::uint64_t, Id> m_products;
+  std::unordered_map<Id, Expansion> m_normal_orders;
+  std::unordered_map<std::uint64_t, Expansion> m_ordered_products;
+
+  static std::uint64_t pair_key(Id a, Id b) {
+    return (std::uint64_t{a} << 32) | b;
+  }
+
+  Expansion expand(std::vector<Operator> operators);
+};
@@ -0,0 +1,73 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "ReachableBasis.h"
+
+#include "NormalOrderer.h"
+#include "TaskScheduler.h"
+
+// A normal-ordered term is a basis state if it only contains creation
+// operators and does not create the same fermion twice.
+static bool is_state(const BasisElement& operators) {
+  for (std::size_t i = 0; i < operators.size(); i++) {
+    if (operators[i].type() != Operator::Type::Creation) {
+      return false;
+    }
+    if (i > 0 && operators[i].is_fermion() &&
+        operators[i] == operators[i - 1]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+ReachableBasis::ReachableBasis(
+    std::size_t n, const Expression& hamiltonian,
+    const std::vector<BasisElement>& seeds)
+    : Basis(n, seeds.empty() ? 0 : seeds.front().size()) {
+  generate_reachable(hamiltonian, seeds);
+}
+
+void ReachableBasis::generate_reachable(
+    const Expression& hamiltonian, const std::vector<BasisElement>& seeds) {
+  std::vector<BasisElement> frontier;
+  for (const BasisElement& seed : seeds) {
+    if (!m_basis_map.contains(seed)) {
+      m_basis_map.insert(seed);
+      frontier.push_back(seed);
+    }
+  }
+
+  // Level-synchronous BFS: the neighbours of the whole frontier are computed
+  // in parallel and then merged in frontier order, so the discovered set does
+  // not depend on the number of threads.
+  while (!frontier.empty()) {
+    std::vector<std::vector<BasisElement>> neighbours(frontier.size());
+
+    TaskScheduler::current().parallel_for(
+        0, frontier.size(), 1, [&](std::size_t i) {
+          Expression::ExpressionMap product =
+              NormalOrderer(hamiltonian.product(frontier[i])).terms();
+          for (const auto& [operators, coeff] : product) {
+            if (coeff != Term::CoeffType{} && is_state(operators)) {
+              neighbours[i].push_back(operators);
+            }
+          }
+        });
+
+    std::vector<BasisElement> next;
+    for (const std::vector<BasisElement>& states : neighbours) {
+      for (const BasisElement& state : states) {
+        if (!m_basis_map.contains(state)) {
+          m_basis_map.insert(state);
+          next.push_back(state);
+        }
+      }
+    }
+    frontier = std::move(next);
+  }
+
+  // Discovery order depends on the seeds, the canonical (lexicographic) order
+  // keeps the indices stable and neighbouring configurations close together.
+  m_basis_map.sort(std::less<BasisElement>{});
+}
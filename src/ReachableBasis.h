@@ -0,0 +1,27 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include "Basis.h"
+#include "Expression.h"
+
+// A basis made of the states that are reachable from a set of seed states
+// under the repeated action of an operator (usually the Hamiltonian). Only
+// the connected sector of the Hilbert space is ever generated, so conserved
+// quantities do not need to be known (or expressible as a BasisFilter) in
+// advance. The seeds must be normal-ordered strings of creation operators.
+class ReachableBasis final : public Basis {
+ public:
+  ReachableBasis(
+      std::size_t n, const Expression& hamiltonian,
+      const std::vector<BasisElement>& seeds);
+
+  // States are discovered by a breadth-first search instead of being
+  // enumerated, see generate_reachable().
+  void generate_combinations(BasisElement&, size_t, size_t, size_t) override {}
+
+ private:
+  void generate_reachable(
+      const Expression& hamiltonian, const std::vector<BasisElement>& seeds);
+};
@@ -0,0 +1,80 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "RowSchedule.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "Assert.h"
+#include "TaskScheduler.h"
+
+RowCostModel::RowCostModel(const Expression& hamiltonian)
+    : m_base{static_cast<double>(hamiltonian.size())} {
+  for (const auto& [operators, coefficient] : hamiltonian.terms()) {
+    Requirement requirement{0, 0};
+    std::uint64_t created = 0;
+    for (const Operator& op : operators) {
+      LIBMB_ASSERT(op.is_fermion() && op.orbital() < 32);
+      const std::uint64_t bit =
+          std::uint64_t{1}
+          << (2 * op.orbital() + static_cast<std::size_t>(op.spin()));
+      if (op.type() == Operator::Type::Creation) {
+        created |= bit;
+      } else {
+        requirement.occupied |= bit;
+      }
+    }
+    requirement.empty = created & ~requirement.occupied;
+    m_requirements.push_back(requirement);
+  }
+}
+
+RowSchedule::RowSchedule(std::size_t rows, std::size_t chunks)
+    : RowSchedule(std::vector<double>(rows, 1.0), chunks) {}
+
+RowSchedule::RowSchedule(std::span<const double> costs, std::size_t chunks) {
+  LIBMB_ASSERT(chunks > 0);
+  // Without any cost, fall back to counting rows.
+  const double sum = std::accumulate(costs.begin(), costs.end(), 0.0);
+  auto cost = [&](std::size_t i) { return sum > 0.0 ? costs[i] : 1.0; };
+  const double total = sum > 0.0 ? sum : static_cast<double>(costs.size());
+  const double target = total / static_cast<double>(chunks);
+
+  // Cut whenever the running cost passes the next multiple of the target.
+  // A row costlier than the target is put alone in its chunk.
+  std::vector<double> chunk_costs;
+  m_bounds.push_back(0);
+  double running = 0.0;
+  double chunk_cost = 0.0;
+  double threshold = target;
+  auto cut = [&](std::size_t end) {
+    m_bounds.push_back(end);
+    chunk_costs.push_back(chunk_cost);
+    chunk_cost = 0.0;
+    while (threshold <= running) {
+      threshold += target;
+    }
+  };
+  for (std::size_t i = 0; i < costs.size(); i++) {
+    if (i > m_bounds.back() && cost(i) >= target) {
+      cut(i);
+    }
+    running += cost(i);
+    chunk_cost += cost(i);
+    if (running >= threshold || i + 1 == costs.size()) {
+      cut(i + 1);
+    }
+  }
+
+  m_order.resize(chunk_costs.size());
+  std::iota(m_order.begin(), m_order.end(), 0);
+  std::stable_sort(
+      m_order.begin(), m_order.end(), [&](std::size_t a, std::size_t b) {
+        return chunk_costs[a] > chunk_costs[b];
+      });
+}
+
+std::size_t RowSchedule::default_chunks(const TaskScheduler& scheduler) {
+  return 8 * scheduler.concurrency();
+}
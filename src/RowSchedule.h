@@ -0,0 +1,81 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Expression.h"
+#include "TaskScheduler.h"
+
+// Cheap estimate of the work of one row of the Hamiltonian matrix, for
+// fermionic states given as occupation words (see occupation_bits()).
+//
+// Every term is multiplied with the state, and the ones that do not
+// annihilate it are also normal ordered into the row, so a row costs
+//
+//   terms + number of terms that can act on the state
+//
+// in units of one term product. A term can act when the spin-orbitals it
+// annihilates are occupied and the others it creates are empty, which is
+// two masks to test.
+class RowCostModel {
+ public:
+  explicit RowCostModel(const Expression& hamiltonian);
+
+  double operator()(std::uint64_t word) const {
+    double cost = m_base;
+    for (const Requirement& requirement : m_requirements) {
+      if ((word & requirement.occupied) == requirement.occupied &&
+          (word & requirement.empty) == 0) {
+        cost += 1.0;
+      }
+    }
+    return cost;
+  }
+
+ private:
+  struct Requirement {
+    std::uint64_t occupied;
+    std::uint64_t empty;
+  };
+
+  std::vector<Requirement> m_requirements;
+  double m_base;
+};
+
+// Rows split into contiguous chunks of about equal estimated cost, handed
+// out from the most expensive one down. Run as tasks (or with
+// schedule(dynamic, 1)), the expensive rows are started first and the
+// threads finish together, instead of one thread picking up a heavy row at
+// the end.
+class RowSchedule {
+ public:
+  // Rows of equal cost.
+  RowSchedule(std::size_t rows, std::size_t chunks = default_chunks());
+
+  RowSchedule(
+      std::span<const double> costs, std::size_t chunks = default_chunks());
+
+  std::size_t size() const { return m_order.size(); }
+
+  // Range [first, last) of rows of the k-th chunk to run.
+  std::pair<std::size_t, std::size_t> chunk(std::size_t k) const {
+    const std::size_t c = m_order[k];
+    return {m_bounds[c], m_bounds[c + 1]};
+  }
+
+  // A few chunks per thread of the scheduler, so that the estimate need
+  // not be exact.
+  static std::size_t default_chunks(const TaskScheduler& scheduler);
+  static std::size_t default_chunks() {
+    return default_chunks(TaskScheduler::current());
+  }
+
+ private:
+  std::vector<std::size_t> m_bounds;
+  std::vector<std::size_t> m_order;
+};
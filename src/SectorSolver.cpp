@@ -0,0 +1,61 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "SectorSolver.h"
+
+#include "Lanczos.h"
+
+SectorSolver::SectorSolver(TaskScheduler& scheduler)
+    : m_scheduler{scheduler},
+      m_solver{[&scheduler](const CsrMatrix<Coeff>& matrix) {
+        return lowest_eigenvalue(matrix, scheduler);
+      }} {}
+
+SectorSolver::SectorSolver(Solver solver, TaskScheduler& scheduler)
+    : m_scheduler{scheduler}, m_solver{std::move(solver)} {}
+
+std::vector<SectorSolver::Result> SectorSolver::run() {
+  std::vector<Result> results(m_blocks);
+  TaskGroup group(m_scheduler);
+  for (const Job& job : m_jobs) {
+    group.run([this, &job, &results]() {
+      job.solve(
+          m_scheduler, m_solver,
+          std::span(results).subspan(job.first, job.count));
+    });
+  }
+  group.wait();
+
+  m_jobs.clear();
+  m_blocks = 0;
+  return results;
+}
+
+double SectorSolver::lowest_eigenvalue(
+    const CsrMatrix<Coeff>& matrix, TaskScheduler& scheduler) {
+  const auto offsets = matrix.row_offsets();
+  const auto columns = matrix.columns();
+  const auto values = matrix.values();
+  auto row = [&](std::span<const Coeff> x, std::span<Coeff> y) {
+    return [=](std::size_t i) {
+      Coeff sum = 0.0;
+      for (std::size_t k = offsets[i]; k < offsets[i + 1]; k++) {
+        sum += values[k] * x[columns[k]];
+      }
+      y[i] = sum;
+    };
+  };
+
+  const bool parallel = matrix.rows() >= parallel_rows;
+  return ::lowest_eigenvalue(
+      matrix.rows(), [&](std::span<const Coeff> x, std::span<Coeff> y) {
+        if (parallel) {
+          scheduler.parallel_for(0, matrix.rows(), 1024, row(x, y));
+          return;
+        }
+        const auto multiply = row(x, y);
+        for (std::size_t i = 0; i < matrix.rows(); i++) {
+          multiply(i);
+        }
+      });
+}
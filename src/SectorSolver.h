@@ -0,0 +1,116 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <functional>
+#include <limits>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "CsrMatrix.h"
+#include "Model.h"
+#include "TaskScheduler.h"
+
+// Builds and diagonalizes many independent blocks of Hamiltonians (symmetry
+// sectors, parameter values) concurrently, on one TaskScheduler.
+//
+// Every job is a task that generates its basis, then assembles and solves
+// the block of each of its models in that basis, one after the other, and
+// releases it. Only the bases and blocks of the running jobs are alive at
+// once, and models that share a basis (the same sector for several
+// parameter values) generate it once. Jobs start in the order they were
+// added, so the large ones should be added first. The generation and the
+// assembly of a block are split into tasks, and so are the matrix-vector
+// products of a large block, so the threads left idle by the small blocks
+// steal from the large ones. The products of a small block stay on one
+// thread, where splitting them would cost more than it saves.
+class SectorSolver {
+ public:
+  using Coeff = Term::CoeffType;
+  // Quantity of interest of a block, by default its lowest eigenvalue. It
+  // is called concurrently for different blocks.
+  using Solver = std::function<double(const CsrMatrix<Coeff>&)>;
+
+  explicit SectorSolver(TaskScheduler& scheduler = TaskScheduler::current());
+
+  SectorSolver(Solver solver, TaskScheduler& scheduler);
+
+  // Adds the block of `model` in the basis returned by make_basis(), which
+  // must be a std::unique_ptr to a Basis or a SymmetricBasis. The model
+  // must outlive run(). Returns the index of the block.
+  template <typename MakeBasis>
+  std::size_t add(const Model& model, MakeBasis make_basis) {
+    return add(std::vector<const Model*>{&model}, std::move(make_basis));
+  }
+
+  // Adds the blocks of several models in the same basis, which is generated
+  // once. Returns the index of the block of the first model; the others
+  // follow in order.
+  template <typename MakeBasis>
+  std::size_t add(std::vector<const Model*> models, MakeBasis make_basis);
+
+  // Blocks added since the last run().
+  std::size_t size() const { return m_blocks; }
+
+  struct Result {
+    // Dimension of the block, 0 if the sector is empty.
+    std::size_t size;
+    double value;
+  };
+
+  // Runs every job added since the last call. Empty sectors are skipped and
+  // give an infinite value.
+  std::vector<Result> run();
+
+  // Blocks of at least this many rows parallelize their products.
+  static constexpr std::size_t parallel_rows = 1 << 14;
+
+  // Lowest eigenvalue by the Lanczos method, with the products split into
+  // tasks for large blocks.
+  static double lowest_eigenvalue(
+      const CsrMatrix<Coeff>& matrix, TaskScheduler& scheduler);
+
+ private:
+  // Generates a basis and solves the blocks of one or more models in it.
+  struct Job {
+    std::size_t first;
+    std::size_t count;
+    std::function<void(TaskScheduler&, const Solver&, std::span<Result>)>
+        solve;
+  };
+
+  TaskScheduler& m_scheduler;
+  Solver m_solver;
+  std::vector<Job> m_jobs;
+  std::size_t m_blocks = 0;
+};
+
+template <typename MakeBasis>
+std::size_t SectorSolver::add(
+    std::vector<const Model*> models, MakeBasis make_basis) {
+  const std::size_t first = m_blocks;
+  Job job;
+  job.first = first;
+  job.count = models.size();
+  job.solve = [models = std::move(models), make_basis = std::move(make_basis)](
+                  TaskScheduler& scheduler, const Solver& solver,
+                  std::span<Result> results) {
+    const auto basis = make_basis();
+    const std::size_t size = basis->size();
+    for (std::size_t k = 0; k < models.size(); k++) {
+      results[k] = {size, std::numeric_limits<double>::infinity()};
+      if (size == 0) {
+        continue;
+      }
+      SparseMatrix<Coeff> elements;
+      models[k]->compute_matrix_elements(
+          *basis, elements, Model::Assembly::Unordered, scheduler);
+      results[k].value = solver(CsrMatrix<Coeff>(size, size, elements));
+    }
+  };
+  m_blocks += job.count;
+  m_jobs.push_back(std::move(job));
+  return first;
+}
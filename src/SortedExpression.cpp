@@ -0,0 +1,114 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "SortedExpression.h"
+
+#include <algorithm>
+
+static bool operators_less(
+    std::span<const Operator> a, std::span<const Operator> b) {
+  return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+SortedExpression::SortedExpression(const Expression& expression)
+    : SortedExpression(expression.terms()) {}
+
+SortedExpression::SortedExpression(const Expression::ExpressionMap& terms)
+    : m_offsets{0} {
+  // Sort pointers to the map entries rather than the entries themselves.
+  using Entry = Expression::ExpressionMap::value_type;
+  std::vector<const Entry*> entries;
+  entries.reserve(terms.size());
+  std::size_t length = 0;
+  for (const Entry& entry : terms) {
+    entries.push_back(&entry);
+    length += entry.first.size();
+  }
+  std::ranges::sort(entries, [](const Entry* a, const Entry* b) {
+    return operators_less(a->first, b->first);
+  });
+
+  m_operators.reserve(length);
+  m_offsets.reserve(terms.size() + 1);
+  m_coefficients.reserve(terms.size());
+  for (const Entry* entry : entries) {
+    push_back(entry->first, entry->second);
+  }
+}
+
+void SortedExpression::push_back(
+    std::span<const Operator> operators, Coeff coefficient) {
+  m_operators.insert(m_operators.end(), operators.begin(), operators.end());
+  m_offsets.push_back(m_operators.size());
+  m_coefficients.push_back(coefficient);
+}
+
+SortedExpression::Coeff SortedExpression::coefficient(
+    std::span<const Operator> operators) const {
+  std::size_t first = 0;
+  std::size_t last = size();
+  while (first < last) {
+    const std::size_t middle = first + (last - first) / 2;
+    if (operators_less(this->operators(middle), operators)) {
+      first = middle + 1;
+    } else {
+      last = middle;
+    }
+  }
+  if (first < size() &&
+      std::ranges::equal(this->operators(first), operators)) {
+    return m_coefficients[first];
+  }
+  return 0.0;
+}
+
+Expression::ExpressionMap SortedExpression::terms() const {
+  Expression::ExpressionMap result;
+  result.reserve(size());
+  for (std::size_t i = 0; i < size(); i++) {
+    auto ops = operators(i);
+    result.emplace(
+        std::vector<Operator>(ops.begin(), ops.end()), m_coefficients[i]);
+  }
+  return result;
+}
+
+SortedExpression operator+(
+    const SortedExpression& lhs, const SortedExpression& rhs) {
+  SortedExpression result;
+  result.m_operators.reserve(lhs.m_operators.size() + rhs.m_operators.size());
+  result.m_offsets.reserve(lhs.size() + rhs.size() + 1);
+  result.m_coefficients.reserve(lhs.size() + rhs.size());
+
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i < lhs.size() && j < rhs.size()) {
+    const auto a = lhs.operators(i);
+    const auto b = rhs.operators(j);
+    if (operators_less(a, b)) {
+      result.push_back(a, lhs.m_coefficients[i++]);
+    } else if (operators_less(b, a)) {
+      result.push_back(b, rhs.m_coefficients[j++]);
+    } else {
+      result.push_back(a, lhs.m_coefficients[i++] + rhs.m_coefficients[j++]);
+    }
+  }
+  for (; i < lhs.size(); i++) {
+    result.push_back(lhs.operators(i), lhs.m_coefficients[i]);
+  }
+  for (; j < rhs.size(); j++) {
+    result.push_back(rhs.operators(j), rhs.m_coefficients[j]);
+  }
+  return result;
+}
+
+SortedExpression& SortedExpression::operator*=(double coefficient) {
+  // A complex<double> is laid out as two doubles, so the coefficients are
+  // scaled as one flat array, which the compiler vectorizes.
+  double* values = reinterpret_cast<double*>(m_coefficients.data());
+  const std::size_t n = 2 * m_coefficients.size();
+  for (std::size_t k = 0; k < n; k++) {
+    values[k] *= coefficient;
+  }
+  return *this;
+}
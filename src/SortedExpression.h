@@ -0,0 +1,100 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Expression.h"
+
+// An Expression stored as a structure of arrays: the operators of all terms
+// back to back in one buffer, the offset of every term in it, and the
+// coefficients in a parallel array. The terms are kept sorted by their
+// operators, so that sums and comparisons are linear merges and scaling is
+// a plain loop over the coefficients, instead of hash map traversals.
+//
+// Meant for bulk algebra on large expressions that are built once; it does
+// not support inserting single terms in place.
+class SortedExpression {
+ public:
+  using Coeff = Term::CoeffType;
+
+  SortedExpression() : m_offsets{0} {}
+
+  explicit SortedExpression(const Expression& expression);
+
+  explicit SortedExpression(const Expression::ExpressionMap& terms);
+
+  std::size_t size() const { return m_coefficients.size(); }
+
+  bool empty() const { return m_coefficients.empty(); }
+
+  std::span<const Operator> operators(std::size_t i) const {
+    return std::span<const Operator>(m_operators)
+        .subspan(m_offsets[i], m_offsets[i + 1] - m_offsets[i]);
+  }
+
+  Coeff coefficient(std::size_t i) const { return m_coefficients[i]; }
+
+  std::span<const Coeff> coefficients() const { return m_coefficients; }
+
+  std::span<Coeff> coefficients() { return m_coefficients; }
+
+  // The coefficient of `operators`, or zero if there is no such term.
+  Coeff coefficient(std::span<const Operator> operators) const;
+
+  Expression::ExpressionMap terms() const;
+
+  Expression expression() const { return Expression(terms()); }
+
+  // Terms present in both are compared by coefficient, like Expression: a
+  // term with a zero coefficient is not the same as a missing term.
+  bool operator==(const SortedExpression& other) const {
+    return m_coefficients == other.m_coefficients &&
+           m_offsets == other.m_offsets && m_operators == other.m_operators;
+  }
+
+  bool operator!=(const SortedExpression& other) const {
+    return !(*this == other);
+  }
+
+  friend SortedExpression operator+(
+      const SortedExpression& lhs, const SortedExpression& rhs);
+
+  SortedExpression& operator+=(const SortedExpression& other) {
+    *this = *this + other;
+    return *this;
+  }
+
+  SortedExpression& operator*=(Coeff coefficient) {
+    for (Coeff& value : m_coefficients) {
+      value *= coefficient;
+    }
+    return *this;
+  }
+
+  SortedExpression& operator*=(double coefficient);
+
+  friend SortedExpression operator*(
+      double coefficient, SortedExpression expression) {
+    expression *= coefficient;
+    return expression;
+  }
+
+  SortedExpression negate() const& { return -1.0 * *this; }
+
+  SortedExpression negate() && {
+    *this *= -1.0;
+    return std::move(*this);
+  }
+
+ private:
+  // Appends a term, which must sort after the current last one.
+  void push_back(std::span<const Operator> operators, Coeff coefficient);
+
+  std::vector<Operator> m_operators;
+  std::vector<std::size_t> m_offsets;
+  std::vector<Coeff> m_coefficients;
+};
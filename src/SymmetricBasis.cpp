@@ -0,0 +1,127 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "SymmetricBasis.h"
+
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+#include "BasisGenerator.h"
+#include "TaskScheduler.h"
+
+SymmetricBasis::SymmetricBasis(
+    std::size_t n, std::size_t m, SymmetryGroup group, BasisFilter* filter)
+    : Basis(n, m, filter), m_group(std::move(group)) {
+  check_group();
+  generate_representatives();
+}
+
+SymmetricBasis::SymmetricBasis(
+    std::size_t n, std::size_t m, SymmetryGroup group)
+    : Basis(n, m), m_group(std::move(group)) {
+  check_group();
+  generate_representatives();
+}
+
+void SymmetricBasis::check_group() const {
+  for (std::size_t g = 0; g < m_group.size(); g++) {
+    if (!m_group.operation(g).preserves(m_orbitals, m_particles)) {
+      throw std::invalid_argument(
+          "SymmetricBasis: the group must act on the orbitals of the basis "
+          "and conserve the number of particles");
+    }
+  }
+}
+
+std::optional<std::pair<std::size_t, SymmetricBasis::Phase>>
+SymmetricBasis::find(const BasisElement& state) const {
+  for (const Operator& op : state) {
+    if (!op.is_fermion() || op.type() != Operator::Type::Creation) {
+      return std::nullopt;
+    }
+  }
+  const std::uint64_t word = occupation_bits(state);
+  if (static_cast<std::size_t>(std::popcount(word)) != state.size()) {
+    return std::nullopt;
+  }
+
+  const Orbit o = orbit(word);
+  const BasisElement representative =
+      element_from_occupation_bits(o.representative);
+  if (!contains(representative)) {
+    return std::nullopt;
+  }
+  const std::size_t i = index(representative);
+  return std::make_pair(i, o.phase * m_overlaps[i]);
+}
+
+SymmetricBasis::Orbit SymmetricBasis::orbit(std::uint64_t word) const {
+  Orbit result{word, 1.0};
+  for (std::size_t g = 0; g < m_group.size(); g++) {
+    auto [image, phase] = m_group.operation(g).apply(word);
+    if (g == 0 || canonical_less(image, result.representative)) {
+      result = {image, phase * std::conj(m_group.character(g))};
+    }
+  }
+  return result;
+}
+
+std::optional<double> SymmetricBasis::projection(std::uint64_t word) const {
+  Phase sum = 0.0;
+  for (std::size_t g = 0; g < m_group.size(); g++) {
+    auto [image, phase] = m_group.operation(g).apply(word);
+    // Operations that change the number of particles (e.g. particle-hole
+    // away from half filling) are rejected by check_group().
+    LIBMB_ASSERT(std::popcount(image) == std::popcount(word));
+    if (canonical_less(image, word)) {
+      return std::nullopt;
+    }
+    if (image == word) {
+      sum += std::conj(m_group.character(g)) * phase;
+    }
+  }
+
+  // The sum over the stabilizer is either its order or zero.
+  const double size = static_cast<double>(m_group.size());
+  if (sum.real() < 0.5) {
+    return std::nullopt;
+  }
+  return sum.real() / size;
+}
+
+void SymmetricBasis::generate_representatives() {
+  // The states are streamed in canonical order and checked in batches, so
+  // that the orbits (|G| times the work of the plain basis) are computed in
+  // parallel while the representatives stay sorted.
+  static constexpr std::size_t batch_size = 1 << 14;
+  std::vector<std::uint64_t> batch;
+  std::vector<std::optional<double>> projections;
+  batch.reserve(batch_size);
+
+  auto flush = [&]() {
+    projections.assign(batch.size(), std::nullopt);
+    TaskScheduler::current().parallel_for(
+        0, batch.size(), 256,
+        [&](std::size_t i) { projections[i] = projection(batch[i]); });
+    for (std::size_t i = 0; i < batch.size(); i++) {
+      if (projections[i].has_value()) {
+        m_basis_map.insert(element_from_occupation_bits(batch[i]));
+        m_overlaps.push_back(std::sqrt(*projections[i]));
+      }
+    }
+    batch.clear();
+  };
+
+  for (const BasisElement& element :
+       FermionicBasisGenerator(m_orbitals, m_particles)) {
+    if (!m_basis_filter->filter(element)) {
+      continue;
+    }
+    batch.push_back(occupation_bits(element));
+    if (batch.size() == batch_size) {
+      flush();
+    }
+  }
+  flush();
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <optional>
+
+#include "Basis.h"
+#include "Symmetry.h"
+
+// Fermionic basis of one symmetry sector. Each element is the representative
+// of an orbit of the group (its smallest state in canonical order) and
+// stands for the symmetrized state
+//
+//   |r~> = P |r> / sqrt(<r|P|r>),  P = 1/|G| sum_g conj(chi(g)) g,
+//
+// Orbits with <r|P|r> = 0 have no state in the sector and are skipped. The
+// filter, if any, must be invariant under the group. The constructors throw
+// std::invalid_argument unless every operation of the group acts on the n
+// orbitals of the basis and conserves its m particles.
+class SymmetricBasis final : public Basis {
+ public:
+  using Phase = SymmetryGroup::Phase;
+
+  SymmetricBasis(
+      std::size_t n, std::size_t m, SymmetryGroup group, BasisFilter* filter);
+
+  SymmetricBasis(std::size_t n, std::size_t m, SymmetryGroup group);
+
+  // Representatives are selected from a stream of states, see
+  // generate_representatives().
+  void generate_combinations(BasisElement&, size_t, size_t, size_t) override {}
+
+  const SymmetryGroup& group() const { return m_group; }
+
+  // <i~|i>, the overlap of a symmetrized state with its representative.
+  double overlap(std::size_t i) const { return m_overlaps[i]; }
+
+  // Index of the symmetrized state |t~> whose orbit contains `state`, and
+  // the overlap <t~|state>. Empty if the orbit is not in the basis or
+  // `state` is not a string of fermionic creation operators.
+  std::optional<std::pair<std::size_t, Phase>> find(
+      const BasisElement& state) const;
+
+ private:
+  struct Orbit {
+    std::uint64_t representative;
+    Phase phase;
+  };
+
+  // Representative of the orbit of `word` and the phase of the operation
+  // that maps `word` onto it, multiplied by the conjugate character.
+  Orbit orbit(std::uint64_t word) const;
+
+  // <r|P|r>, or nothing if r is not the representative of its orbit.
+  std::optional<double> projection(std::uint64_t word) const;
+
+  void check_group() const;
+
+  void generate_representatives();
+
+  SymmetryGroup m_group;
+  std::vector<double> m_overlaps;
+};
@@ -0,0 +1,355 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "Symmetry.h"
+
+#include <algorithm>
+#include <bit>
+#include <numbers>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+
+#include "Assert.h"
+
+SymmetryOperation SymmetryOperation::site_permutation(
+    const std::vector<std::size_t>& permutation) {
+  Step step;
+  step.image.resize(2 * permutation.size());
+  for (std::size_t i = 0; i < permutation.size(); i++) {
+    LIBMB_ASSERT(permutation[i] < permutation.size());
+    step.image[2 * i] = 2 * permutation[i];
+    step.image[2 * i + 1] = 2 * permutation[i] + 1;
+  }
+
+  SymmetryOperation result;
+  result.m_steps.push_back(std::move(step));
+  return result;
+}
+
+SymmetryOperation SymmetryOperation::spin_flip(std::size_t orbitals) {
+  Step step;
+  step.image.resize(2 * orbitals);
+  for (std::size_t k = 0; k < step.image.size(); k++) {
+    step.image[k] = k ^ 1;
+  }
+
+  SymmetryOperation result;
+  result.m_steps.push_back(std::move(step));
+  return result;
+}
+
+SymmetryOperation SymmetryOperation::particle_hole(
+    const std::vector<int>& sublattice_signs) {
+  LIBMB_ASSERT(2 * sublattice_signs.size() <= 64);
+  Step step;
+  step.signs.resize(2 * sublattice_signs.size());
+  for (std::size_t i = 0; i < sublattice_signs.size(); i++) {
+    step.signs[2 * i] = sublattice_signs[i];
+    step.signs[2 * i + 1] = sublattice_signs[i];
+  }
+
+  // The square of the transformation maps every state to itself, but
+  // possibly with a sign. Measure it on the vacuum and compensate.
+  auto [full, there] = apply(step, 0);
+  auto [vacuum, back] = apply(step, full);
+  LIBMB_ASSERT(vacuum == 0);
+  step.phase = 1.0 / std::sqrt(there * back);
+
+  SymmetryOperation result;
+  result.m_steps.push_back(std::move(step));
+  return result;
+}
+
+SymmetryOperation SymmetryOperation::operator*(
+    const SymmetryOperation& other) const {
+  SymmetryOperation result = other;
+  for (const Step& step : m_steps) {
+    // Consecutive permutations are merged into one. The phases agree since
+    // the permutations of creation operators form a representation.
+    if (!result.m_steps.empty() && result.m_steps.back().signs.empty() &&
+        step.signs.empty() &&
+        result.m_steps.back().image.size() == step.image.size()) {
+      for (std::size_t& k : result.m_steps.back().image) {
+        k = step.image[k];
+      }
+    } else {
+      result.m_steps.push_back(step);
+    }
+  }
+  return result;
+}
+
+std::pair<std::uint64_t, SymmetryOperation::Phase> SymmetryOperation::apply(
+    std::uint64_t word) const {
+  Phase phase = 1.0;
+  for (const Step& step : m_steps) {
+    auto [image, step_phase] = apply(step, word);
+    word = image;
+    phase *= step_phase;
+  }
+  return {word, phase};
+}
+
+bool SymmetryOperation::preserves(
+    std::size_t orbitals, std::size_t particles) const {
+  std::size_t count = particles;
+  for (const Step& step : m_steps) {
+    if (step.image.size() + step.signs.size() != 2 * orbitals) {
+      return false;
+    }
+    if (!step.signs.empty()) {
+      count = 2 * orbitals - count;
+    }
+  }
+  return count == particles;
+}
+
+std::pair<std::uint64_t, SymmetryOperation::Phase> SymmetryOperation::apply(
+    const Step& step, std::uint64_t word) {
+  std::uint64_t result = 0;
+  int transpositions = 0;
+
+  if (step.signs.empty()) {
+    // Place the images in the order of the original creation operators and
+    // count how many already placed ones they have to move past.
+    for (std::uint64_t bits = word; bits != 0; bits &= bits - 1) {
+      const auto k = static_cast<std::size_t>(std::countr_zero(bits));
+      LIBMB_ASSERT(k < step.image.size());
+      const std::uint64_t target = std::uint64_t{1} << step.image[k];
+      transpositions += std::popcount(result & ~(2 * target - 1));
+      result |= target;
+    }
+  } else {
+    // prod_k s_k c(k) |full>, with the rightmost (highest) k applied first.
+    const std::size_t n = step.signs.size();
+    result = n == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << n) - 1;
+    LIBMB_ASSERT((word & ~result) == 0);
+    for (std::uint64_t bits = word; bits != 0;) {
+      const auto k = static_cast<std::size_t>(63 - std::countl_zero(bits));
+      const std::uint64_t bit = std::uint64_t{1} << k;
+      transpositions += std::popcount(result & (bit - 1));
+      if (step.signs[k] < 0) {
+        transpositions++;
+      }
+      result ^= bit;
+      bits ^= bit;
+    }
+  }
+
+  return {result, transpositions % 2 == 0 ? step.phase : -step.phase};
+}
+
+SymmetryGroup operator*(const SymmetryGroup& lhs, const SymmetryGroup& rhs) {
+  SymmetryGroup result;
+  result.m_operations.clear();
+  result.m_characters.clear();
+  for (std::size_t i = 0; i < lhs.size(); i++) {
+    for (std::size_t j = 0; j < rhs.size(); j++) {
+      result.add(
+          lhs.operation(i) * rhs.operation(j),
+          lhs.character(i) * rhs.character(j));
+    }
+  }
+  return result;
+}
+
+SymmetryGroup spin_flip_symmetry(std::size_t orbitals, int parity) {
+  LIBMB_ASSERT(parity == 1 || parity == -1);
+  SymmetryGroup result;
+  result.add(SymmetryOperation::spin_flip(orbitals), parity);
+  return result;
+}
+
+SymmetryGroup particle_hole_symmetry(
+    const std::vector<int>& sublattice_signs, int parity) {
+  LIBMB_ASSERT(parity == 1 || parity == -1);
+  SymmetryGroup result;
+  result.add(SymmetryOperation::particle_hole(sublattice_signs), parity);
+  return result;
+}
+
+SymmetryGroup site_permutation_group(
+    const std::vector<std::vector<std::size_t>>& permutations,
+    const std::vector<SymmetryGroup::Phase>& characters) {
+  if (permutations.size() != characters.size()) {
+    throw std::invalid_argument(
+        "site_permutation_group: one character per permutation is needed");
+  }
+  static constexpr double tolerance = 1e-12;
+
+  // Every permutation maps the same sites onto themselves, so that their
+  // products are defined.
+  const std::size_t sites =
+      permutations.empty() ? 0 : permutations.front().size();
+  for (const auto& permutation : permutations) {
+    std::vector<std::size_t> sorted = permutation;
+    std::sort(sorted.begin(), sorted.end());
+    for (std::size_t k = 0; k < sorted.size(); k++) {
+      if (sorted[k] != k || permutation.size() != sites) {
+        throw std::invalid_argument(
+            "site_permutation_group: not a permutation of the sites");
+      }
+    }
+  }
+
+  std::vector<std::size_t> product(sites);
+  bool has_identity = false;
+  for (std::size_t i = 0; i < permutations.size(); i++) {
+    for (std::size_t j = 0; j < permutations.size(); j++) {
+      for (std::size_t k = 0; k < sites; k++) {
+        product[k] = permutations[i][permutations[j][k]];
+      }
+      auto it = std::find(permutations.begin(), permutations.end(), product);
+      if (it == permutations.end()) {
+        throw std::invalid_argument(
+            "site_permutation_group: permutations are not closed under "
+            "composition");
+      }
+      const SymmetryGroup::Phase difference =
+          characters[i] * characters[j] -
+          characters[static_cast<std::size_t>(it - permutations.begin())];
+      if (std::abs(difference) >= tolerance) {
+        throw std::invalid_argument(
+            "site_permutation_group: characters are not multiplicative");
+      }
+    }
+    if (std::is_sorted(permutations[i].begin(), permutations[i].end())) {
+      has_identity = true;
+    }
+  }
+  if (!has_identity) {
+    throw std::invalid_argument(
+        "site_permutation_group: the identity is missing");
+  }
+
+  // The identity is already in the trivial group.
+  SymmetryGroup result;
+  for (std::size_t i = 0; i < permutations.size(); i++) {
+    if (!std::is_sorted(permutations[i].begin(), permutations[i].end())) {
+      result.add(
+          SymmetryOperation::site_permutation(permutations[i]),
+          characters[i]);
+    }
+  }
+  return result;
+}
+
+template <typename Map>
+static std::vector<std::size_t> lattice_permutation(
+    std::size_t nx, std::size_t ny, Map map) {
+  std::vector<std::size_t> result(nx * ny);
+  for (std::size_t y = 0; y < ny; y++) {
+    for (std::size_t x = 0; x < nx; x++) {
+      auto [image_x, image_y] = map(x, y);
+      result[y * nx + x] = image_y * nx + image_x;
+    }
+  }
+  return result;
+}
+
+static std::vector<std::size_t> quarter_turn(std::size_t n, std::size_t a) {
+  return lattice_permutation(n, n, [n, a](std::size_t x, std::size_t y) {
+    for (std::size_t i = 0; i < a; i++) {
+      std::tie(x, y) = std::make_pair((n - y) % n, x);
+    }
+    return std::make_pair(x, y);
+  });
+}
+
+static SymmetryGroup::Phase unit_phase(double turns) {
+  return std::polar(1.0, 2 * std::numbers::pi * turns);
+}
+
+SymmetryGroup translation_symmetry(
+    std::size_t nx, std::size_t ny, std::size_t kx, std::size_t ky) {
+  std::vector<std::vector<std::size_t>> permutations;
+  std::vector<SymmetryGroup::Phase> characters;
+  for (std::size_t dy = 0; dy < ny; dy++) {
+    for (std::size_t dx = 0; dx < nx; dx++) {
+      permutations.push_back(lattice_permutation(
+          nx, ny, [&](std::size_t x, std::size_t y) {
+            return std::make_pair((x + dx) % nx, (y + dy) % ny);
+          }));
+      const double turns =
+          static_cast<double>(kx * dx) / static_cast<double>(nx) +
+          static_cast<double>(ky * dy) / static_cast<double>(ny);
+      characters.push_back(unit_phase(-turns));
+    }
+  }
+  return site_permutation_group(permutations, characters);
+}
+
+SymmetryGroup inversion_symmetry(std::size_t nx, std::size_t ny, int parity) {
+  LIBMB_ASSERT(parity == 1 || parity == -1);
+  auto inversion =
+      lattice_permutation(nx, ny, [&](std::size_t x, std::size_t y) {
+        return std::make_pair((nx - x) % nx, (ny - y) % ny);
+      });
+  std::vector<std::size_t> identity(nx * ny);
+  std::iota(identity.begin(), identity.end(), 0);
+  return site_permutation_group(
+      {identity, inversion}, {1.0, static_cast<double>(parity)});
+}
+
+SymmetryGroup rotation_symmetry(std::size_t n, int m) {
+  std::vector<std::vector<std::size_t>> permutations;
+  std::vector<SymmetryGroup::Phase> characters;
+  for (std::size_t a = 0; a < 4; a++) {
+    permutations.push_back(quarter_turn(n, a));
+    characters.push_back(unit_phase(m * static_cast<double>(a) / 4));
+  }
+  return site_permutation_group(permutations, characters);
+}
+
+SymmetryGroup d4_symmetry(std::size_t n, D4Irrep irrep) {
+  // Characters of a quarter turn and of the reflection x -> -x. The other
+  // reflections are products of the two.
+  double rotation = 1.0;
+  double reflection = 1.0;
+  switch (irrep) {
+    case D4Irrep::A1:
+      break;
+    case D4Irrep::A2:
+      reflection = -1.0;
+      break;
+    case D4Irrep::B1:
+      rotation = -1.0;
+      break;
+    case D4Irrep::B2:
+      rotation = -1.0;
+      reflection = -1.0;
+      break;
+  }
+
+  auto mirror = lattice_permutation(n, n, [n](std::size_t x, std::size_t y) {
+    return std::make_pair((n - x) % n, y);
+  });
+
+  std::vector<std::vector<std::size_t>> permutations;
+  std::vector<SymmetryGroup::Phase> characters;
+  for (std::size_t a = 0; a < 4; a++) {
+    const std::vector<std::size_t> turn = quarter_turn(n, a);
+    const double character = a % 2 == 0 ? 1.0 : rotation;
+    permutations.push_back(turn);
+    characters.push_back(character);
+
+    std::vector<std::size_t> reflected(turn.size());
+    for (std::size_t k = 0; k < turn.size(); k++) {
+      reflected[k] = turn[mirror[k]];
+    }
+    permutations.push_back(std::move(reflected));
+    characters.push_back(character * reflection);
+  }
+  return site_permutation_group(permutations, characters);
+}
+
+std::vector<int> checkerboard_signs(std::size_t nx, std::size_t ny) {
+  std::vector<int> result(nx * ny);
+  for (std::size_t y = 0; y < ny; y++) {
+    for (std::size_t x = 0; x < nx; x++) {
+      result[y * nx + x] = (x + y) % 2 == 0 ? 1 : -1;
+    }
+  }
+  return result;
+}
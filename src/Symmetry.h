@@ -0,0 +1,141 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <complex>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Symmetry operations of the Fock space of spin-1/2 fermions. They act on
+// occupation words (see occupation_bits()) and map each state to a single
+// other state times a phase, which includes the sign of reordering the
+// creation operators back into canonical order.
+class SymmetryOperation {
+ public:
+  using Phase = std::complex<double>;
+
+  // The identity.
+  SymmetryOperation() = default;
+
+  // Moves the electrons on orbital i to orbital permutation[i], keeping
+  // their spin.
+  static SymmetryOperation site_permutation(
+      const std::vector<std::size_t>& permutation);
+
+  // Exchanges up and down spins on every orbital.
+  static SymmetryOperation spin_flip(std::size_t orbitals);
+
+  // c+(i, s) -> sublattice_signs[i] c(i, s), mapping N particles to
+  // 2 * orbitals - N holes. The overall phase is fixed so that the operation
+  // squares to the identity.
+  static SymmetryOperation particle_hole(
+      const std::vector<int>& sublattice_signs);
+
+  // The operation applying `other` first and then this one.
+  SymmetryOperation operator*(const SymmetryOperation& other) const;
+
+  std::pair<std::uint64_t, Phase> apply(std::uint64_t word) const;
+
+  // Whether the operation maps the states of `particles` fermions on
+  // `orbitals` orbitals onto each other: permutations must act on exactly
+  // these orbitals, and particle-hole transformations must come in pairs
+  // or be applied at half filling.
+  bool preserves(std::size_t orbitals, std::size_t particles) const;
+
+ private:
+  struct Step {
+    // Image of every spin-orbital of a permutation. Empty for a
+    // particle-hole transformation.
+    std::vector<std::size_t> image;
+    // Signs of the spin-orbitals of a particle-hole transformation.
+    std::vector<int> signs;
+    Phase phase{1.0};
+  };
+
+  static std::pair<std::uint64_t, Phase> apply(
+      const Step& step, std::uint64_t word);
+
+  std::vector<Step> m_steps;
+};
+
+// A finite group of symmetry operations together with the characters of a
+// one-dimensional irreducible representation, which label a symmetry
+// sector. The operations must form a group (products are not closed here)
+// and the characters must be a representation of it.
+class SymmetryGroup {
+ public:
+  using Phase = SymmetryOperation::Phase;
+
+  // The trivial group.
+  SymmetryGroup() : m_operations{SymmetryOperation()}, m_characters{1.0} {}
+
+  void add(SymmetryOperation operation, Phase character) {
+    m_operations.push_back(std::move(operation));
+    m_characters.push_back(character);
+  }
+
+  std::size_t size() const { return m_operations.size(); }
+
+  const SymmetryOperation& operation(std::size_t i) const {
+    return m_operations[i];
+  }
+
+  Phase character(std::size_t i) const { return m_characters[i]; }
+
+  // Direct product of two commuting groups.
+  friend SymmetryGroup operator*(
+      const SymmetryGroup& lhs, const SymmetryGroup& rhs);
+
+ private:
+  std::vector<SymmetryOperation> m_operations;
+  std::vector<Phase> m_characters;
+};
+
+// The Z2 sector of spin inversion with the given parity (+1 or -1). It is a
+// symmetry of the Sz = 0 sector of SU(2) invariant Hamiltonians.
+SymmetryGroup spin_flip_symmetry(std::size_t orbitals, int parity);
+
+// The Z2 sector of particle-hole conjugation with the given parity (+1 or
+// -1). It is a symmetry at half filling of Hubbard models on bipartite
+// lattices, with the signs distinguishing the two sublattices.
+SymmetryGroup particle_hole_symmetry(
+    const std::vector<int>& sublattice_signs, int parity);
+
+// A group of site permutations supplied by the user, e.g. the space group
+// of a lattice, with the characters of a one-dimensional irrep. Throws
+// std::invalid_argument unless the permutations are permutations of the
+// same sites that form a group, and the characters are multiplicative.
+SymmetryGroup site_permutation_group(
+    const std::vector<std::vector<std::size_t>>& permutations,
+    const std::vector<SymmetryGroup::Phase>& characters);
+
+// The lattice groups below act on an nx * ny torus whose orbitals are
+// numbered y * nx + x, as in HubbardSquare. Point group operations fix
+// orbital 0. Translations combine with a point group through the direct
+// product only at momenta the point group leaves invariant.
+
+// Translations in the sector of momentum 2 pi (kx / nx, ky / ny).
+SymmetryGroup translation_symmetry(
+    std::size_t nx, std::size_t ny, std::size_t kx, std::size_t ky);
+
+// Inversion r -> -r (rotation by 180 degrees), with parity +1 or -1.
+SymmetryGroup inversion_symmetry(std::size_t nx, std::size_t ny, int parity);
+
+// Rotations by multiples of 90 degrees of an n * n torus, in the sector
+// where a quarter turn has the character i^m. The group is abelian, so
+// the four sectors m = 0, 1, 2, 3 span the whole space.
+SymmetryGroup rotation_symmetry(std::size_t n, int m);
+
+// One-dimensional irreps of the point group D4 (C4v) of the square.
+enum class D4Irrep { A1, A2, B1, B2 };
+
+// Rotations and reflections of an n * n torus. The two-dimensional irrep E
+// does not fit the construction, so these sectors are not complete;
+// rotation_symmetry() covers the whole space instead.
+SymmetryGroup d4_symmetry(std::size_t n, D4Irrep irrep);
+
+// Sublattice signs (-1)^(x + y) of an nx * ny lattice whose orbitals are
+// numbered y * nx + x, as in HubbardSquare. A chain is the case ny = 1.
+std::vector<int> checkerboard_signs(std::size_t nx, std::size_t ny = 1);
@@ -0,0 +1,122 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "TaskScheduler.h"
+
+#include <omp.h>
+
+#include "Assert.h"
+
+// Position of the current thread in the pool it works for, if any.
+static thread_local TaskScheduler* current_scheduler = nullptr;
+static thread_local std::size_t current_index = 0;
+
+TaskScheduler::TaskScheduler(std::size_t concurrency) {
+  LIBMB_ASSERT(concurrency > 0);
+  const std::size_t workers = concurrency - 1;
+  for (std::size_t i = 0; i <= workers; i++) {
+    m_queues.push_back(std::make_unique<Queue>());
+  }
+  for (std::size_t i = 0; i < workers; i++) {
+    m_threads.emplace_back([this, i]() { work(i); });
+  }
+}
+
+TaskScheduler::~TaskScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(m_sleep_mutex);
+    m_stop = true;
+  }
+  m_wake.notify_all();
+  for (std::thread& thread : m_threads) {
+    thread.join();
+  }
+}
+
+TaskScheduler& TaskScheduler::instance() {
+  static TaskScheduler scheduler(
+      static_cast<std::size_t>(omp_get_max_threads()));
+  return scheduler;
+}
+
+TaskScheduler& TaskScheduler::current() {
+  return current_scheduler != nullptr ? *current_scheduler : instance();
+}
+
+void TaskScheduler::submit(Task task) {
+  const std::size_t queue =
+      current_scheduler == this ? current_index : m_threads.size();
+  {
+    std::lock_guard<std::mutex> lock(m_queues[queue]->mutex);
+    m_queues[queue]->tasks.push_back(std::move(task));
+  }
+  m_pending.fetch_add(1, std::memory_order_release);
+  // Taking the lock orders the increment before the check of a worker
+  // about to sleep, so the wake up cannot be lost.
+  { std::lock_guard<std::mutex> lock(m_sleep_mutex); }
+  m_wake.notify_one();
+}
+
+bool TaskScheduler::pop(std::size_t queue, bool back, Task& task) {
+  std::lock_guard<std::mutex> lock(m_queues[queue]->mutex);
+  auto& tasks = m_queues[queue]->tasks;
+  if (tasks.empty()) {
+    return false;
+  }
+  if (back) {
+    task = std::move(tasks.back());
+    tasks.pop_back();
+  } else {
+    task = std::move(tasks.front());
+    tasks.pop_front();
+  }
+  return true;
+}
+
+bool TaskScheduler::run_one() {
+  if (m_pending.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+
+  // The newest task of our own queue is the most likely to be in cache.
+  // Steal the oldest ones, which tend to be the largest, starting from our
+  // neighbour.
+  const bool worker = current_scheduler == this;
+  const std::size_t own = worker ? current_index : m_threads.size();
+  Task task;
+  bool found = pop(own, true, task);
+  for (std::size_t k = 1; !found && k < m_queues.size(); k++) {
+    found = pop((own + k) % m_queues.size(), false, task);
+  }
+  if (!found) {
+    return false;
+  }
+  m_pending.fetch_sub(1, std::memory_order_relaxed);
+  // A thread that does not belong to the pool works for it while it runs
+  // the task, so that the task and what it spawns see it as current().
+  TaskScheduler* const previous_scheduler = current_scheduler;
+  const std::size_t previous_index = current_index;
+  current_scheduler = this;
+  current_index = own;
+  task();
+  current_scheduler = previous_scheduler;
+  current_index = previous_index;
+  return true;
+}
+
+void TaskScheduler::work(std::size_t index) {
+  current_scheduler = this;
+  current_index = index;
+  while (true) {
+    if (run_one()) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(m_sleep_mutex);
+    m_wake.wait(lock, [this]() {
+      return m_stop || m_pending.load(std::memory_order_acquire) != 0;
+    });
+    if (m_stop) {
+      return;
+    }
+  }
+}
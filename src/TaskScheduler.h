@@ -0,0 +1,157 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Persistent pool of threads that run irregular tasks by work stealing.
+//
+// Every worker has its own deque: it pushes and pops the tasks it spawns at
+// the back, and steals from the front of the others when it runs out. A
+// thread waiting for a TaskGroup runs tasks instead of blocking, so tasks
+// can spawn and wait for more tasks (per sector, per parameter, per chunk
+// of rows) without creating threads or deadlocking. The pool has one
+// thread less than the cores it uses, since the thread that waits works.
+class TaskScheduler {
+ public:
+  using Task = std::function<void()>;
+
+  explicit TaskScheduler(std::size_t concurrency);
+  ~TaskScheduler();
+
+  TaskScheduler(const TaskScheduler& other) = delete;
+  TaskScheduler& operator=(const TaskScheduler& other) = delete;
+
+  // Shared by the parallel phases of libmb, sized to omp_get_max_threads()
+  // on first use, so that OMP_NUM_THREADS still sets the number of threads.
+  static TaskScheduler& instance();
+
+  // The pool the calling thread runs a task for, or instance(). Parallel
+  // phases started from a task run on the pool of that task, so nested
+  // work never starts a second pool.
+  static TaskScheduler& current();
+
+  // Threads that run tasks at the same time, counting the waiting one.
+  std::size_t concurrency() const { return m_threads.size() + 1; }
+
+  // The task must not throw; TaskGroup::run() takes tasks that may.
+  void submit(Task task);
+
+  // Runs one queued task on the calling thread. Returns false when there
+  // was none.
+  bool run_one();
+
+  // f(i) for i in [first, last), split in halves down to `grain` indices.
+  template <typename F>
+  void parallel_for(
+      std::size_t first, std::size_t last, std::size_t grain, const F& f);
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  bool pop(std::size_t queue, bool back, Task& task);
+
+  void work(std::size_t index);
+
+  // One queue per worker, and a last one for other threads.
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  std::vector<std::thread> m_threads;
+  std::atomic<std::size_t> m_pending{0};
+  std::mutex m_sleep_mutex;
+  std::condition_variable m_wake;
+  bool m_stop = false;
+};
+
+// Tasks that are waited for together.
+class TaskGroup {
+ public:
+  explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::current())
+      : m_scheduler{scheduler} {}
+
+  // Waits for the tasks, but drops an exception that wait() did not get to
+  // rethrow.
+  ~TaskGroup() { drain(); }
+
+  TaskGroup(const TaskGroup& other) = delete;
+  TaskGroup& operator=(const TaskGroup& other) = delete;
+
+  template <typename F>
+  void run(F&& f) {
+    m_remaining.fetch_add(1, std::memory_order_relaxed);
+    m_scheduler.submit([this, task = std::forward<F>(f)]() {
+      // The task is counted as done even if it throws, or wait() would
+      // never return.
+      try {
+        task();
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(m_exception_mutex);
+        if (!m_exception) {
+          m_exception = std::current_exception();
+        }
+      }
+      m_remaining.fetch_sub(1, std::memory_order_release);
+    });
+  }
+
+  // Runs queued tasks, of this group or others, until the group is done.
+  // Then rethrows the first exception thrown by a task of the group.
+  void wait() {
+    drain();
+    if (m_exception) {
+      std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+  }
+
+ private:
+  void drain() {
+    while (m_remaining.load(std::memory_order_acquire) != 0) {
+      if (!m_scheduler.run_one()) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  TaskScheduler& m_scheduler;
+  std::atomic<std::size_t> m_remaining{0};
+  std::mutex m_exception_mutex;
+  std::exception_ptr m_exception;
+};
+
+template <typename F>
+void TaskScheduler::parallel_for(
+    std::size_t first, std::size_t last, std::size_t grain, const F& f) {
+  const std::size_t size = grain == 0 ? 1 : grain;
+  // The group is declared last, so that it waits for the tasks that still
+  // use `split` before it is destroyed.
+  std::function<void(std::size_t, std::size_t)> split;
+  TaskGroup group(*this);
+  // Hand the upper half to a thief and keep splitting the lower one.
+  split = [&](std::size_t begin, std::size_t end) {
+    while (end - begin > size) {
+      const std::size_t middle = begin + (end - begin) / 2;
+      group.run([&split, middle, end]() { split(middle, end); });
+      end = middle;
+    }
+    for (std::size_t i = begin; i < end; i++) {
+      f(i);
+    }
+  };
+  // Even the first half is a task, so that a thread outside the pool runs
+  // it from wait(), and nested phases of f see this pool as current().
+  group.run([&split, first, last]() { split(first, last); });
+  group.wait();
+}
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <complex>
+#include <utility>
 #include <vector>
 
 #include "Operator.h"
@@ -13,8 +14,8 @@ class Term {
  public:
   using CoeffType = std::complex<double>;
 
-  Term(CoeffType coefficient, const std::vector<Operator>& operators)
-      : m_coefficient{coefficient}, m_operators{operators} {}
+  Term(CoeffType coefficient, std::vector<Operator> operators)
+      : m_coefficient{coefficient}, m_operators{std::move(operators)} {}
 
   Term() = default;
 
@@ -48,41 +49,78 @@ class Term {
     return *this;
   }
 
-  Term product(const Term& other) const {
-    std::vector<Operator> new_operators = m_operators;
+  // The const& overloads build a new term. The && ones work in the buffer
+  // of a temporary, so that chains like a.product(b).negate() only
+  // allocate once.
+  Term product(const Term& other) const& {
+    std::vector<Operator> new_operators;
+    new_operators.reserve(m_operators.size() + other.m_operators.size());
+    new_operators.assign(m_operators.begin(), m_operators.end());
     new_operators.insert(
         new_operators.end(), other.m_operators.begin(),
         other.m_operators.end());
-    return Term(m_coefficient * other.m_coefficient, new_operators);
+    return Term(m_coefficient * other.m_coefficient, std::move(new_operators));
   }
 
-  Term product(const std::vector<Operator>& operators) const {
-    std::vector<Operator> new_operators = m_operators;
+  Term product(const Term& other) && {
+    *this *= other;
+    return std::move(*this);
+  }
+
+  Term product(const std::vector<Operator>& operators) const& {
+    std::vector<Operator> new_operators;
+    new_operators.reserve(m_operators.size() + operators.size());
+    new_operators.assign(m_operators.begin(), m_operators.end());
     new_operators.insert(
         new_operators.end(), operators.begin(), operators.end());
-    return Term(m_coefficient, new_operators);
+    return Term(m_coefficient, std::move(new_operators));
+  }
+
+  Term product(const std::vector<Operator>& operators) && {
+    *this *= operators;
+    return std::move(*this);
   }
 
   friend Term operator*(const Term& lhs, const Term& rhs) {
     return lhs.product(rhs);
   }
 
+  friend Term operator*(Term&& lhs, const Term& rhs) {
+    return std::move(lhs).product(rhs);
+  }
+
   friend Term operator*(const Term& lhs, const std::vector<Operator>& rhs) {
     return lhs.product(rhs);
   }
 
+  friend Term operator*(Term&& lhs, const std::vector<Operator>& rhs) {
+    return std::move(lhs).product(rhs);
+  }
+
   friend std::ostream& operator<<(std::ostream& os, const Term& term);
 
-  Term adjoint() const {
-    std::vector<Operator> adj_operators;
-    for (const auto& op : m_operators) {
-      adj_operators.push_back(op.adjoint());
+  Term adjoint() const& { return Term(*this).adjoint(); }
+
+  Term adjoint() && {
+    adjoint_in_place();
+    return std::move(*this);
+  }
+
+  Term& adjoint_in_place() {
+    for (Operator& op : m_operators) {
+      op = op.adjoint();
     }
-    std::reverse(adj_operators.begin(), adj_operators.end());
-    return Term(std::conj(m_coefficient), adj_operators);
+    std::reverse(m_operators.begin(), m_operators.end());
+    m_coefficient = std::conj(m_coefficient);
+    return *this;
   }
 
-  Term negate() const { return Term(-m_coefficient, m_operators); }
+  Term negate() const& { return Term(-m_coefficient, m_operators); }
+
+  Term negate() && {
+    m_coefficient = -m_coefficient;
+    return std::move(*this);
+  }
 
  private:
   CoeffType m_coefficient;
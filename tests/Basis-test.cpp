@@ -6,11 +6,15 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <optional>
 #include <unordered_set>
 
+#include "BasisGenerator.h"
 #include "BosonicBasis.h"
 #include "FermionicBasis.h"
 #include "GenericBasis.h"
+#include "ReachableBasis.h"
+#include "TaskScheduler.h"
 #include "Term.h"
 
 using testing::ElementsAre;
@@ -44,6 +48,26 @@ TEST(FermionicBasisTest, ConstructorAndAttributes) {
   EXPECT_EQ(basis.elements().size(), binomial(4, 2));
 }
 
+TEST(FermionicBasisTest, IndependentOfThreadCount) {
+  // The basis is generated on the pool of the task that constructs it.
+  TaskScheduler one_thread(1);
+  TaskScheduler four_threads(4);
+  std::optional<FermionicBasis> serial;
+  std::optional<FermionicBasis> parallel;
+  TaskGroup serial_group(one_thread);
+  serial_group.run([&]() { serial.emplace(6, 5, new TotalSpinFilter(1)); });
+  serial_group.wait();
+  TaskGroup parallel_group(four_threads);
+  parallel_group.run(
+      [&]() { parallel.emplace(6, 5, new TotalSpinFilter(1)); });
+  parallel_group.wait();
+
+  EXPECT_EQ(serial->elements(), parallel->elements());
+  for (std::size_t i = 0; i < parallel->size(); i++) {
+    EXPECT_EQ(parallel->index(serial->element(i)), i);
+  }
+}
+
 TEST(BasisTest, BasisGeneration) {
   FermionicBasis basis(2, 2, /*allow_double_occupancy=*/true);
   EXPECT_EQ(basis.elements().size(), 6);
@@ -186,6 +210,126 @@ TEST(BasisTest, SortBasis) {
   EXPECT_EQ(*basis.elements().rbegin(), last);
 }
 
+TEST(FermionicBasisGeneratorTest, SameOrderAsFermionicBasis) {
+  for (std::size_t orbs = 0; orbs < 5; orbs++) {
+    for (std::size_t parts = 0; parts < 2 * orbs + 2; parts++) {
+      for (bool allow_double_occupancy : {true, false}) {
+        FermionicBasis basis(orbs, parts, allow_double_occupancy);
+        FermionicBasisGenerator generator(orbs, parts, allow_double_occupancy);
+
+        std::vector<BasisElement> streamed;
+        for (const BasisElement& element : generator) {
+          streamed.push_back(element);
+        }
+        EXPECT_EQ(streamed, basis.elements());
+        EXPECT_EQ(generator.count(), basis.size());
+      }
+    }
+  }
+}
+
+TEST(FermionicBasisGeneratorTest, Filter) {
+  FermionicBasis basis(4, 4, new TotalSpinFilter(0));
+  FermionicBasisGenerator generator(4, 4, new TotalSpinFilter(0));
+
+  std::vector<BasisElement> streamed;
+  for (const BasisElement& element : generator) {
+    streamed.push_back(element);
+  }
+  EXPECT_EQ(streamed, basis.elements());
+  EXPECT_EQ(generator.count(), 36);
+}
+
+TEST(ElementFilterTest, MatchesRuntimeFilter) {
+  FermionicBasis runtime(4, 4, new TotalSpinFilter(0));
+  FermionicBasis inlined(4, 4, total_spin_filter(0));
+  EXPECT_EQ(runtime.elements(), inlined.elements());
+
+  BosonicBasis bosonic_runtime(3, 1, new SingleSpinBasisFilter(Up));
+  BosonicBasis bosonic_inlined(3, 1, single_spin_filter(Up));
+  EXPECT_EQ(bosonic_runtime.elements(), bosonic_inlined.elements());
+
+  GenericBasis generic_runtime(3, 2);
+  GenericBasis generic_inlined(3, 2, accept_all_filter());
+  EXPECT_EQ(generic_runtime.elements(), generic_inlined.elements());
+}
+
+TEST(ElementFilterTest, Combinators) {
+  auto first_orbital_empty = ElementFilter([](const BasisElement& e) {
+    return std::none_of(e.begin(), e.end(), [](const Operator& op) {
+      return op.orbital() == 0;
+    });
+  });
+
+  FermionicBasis all(3, 2);
+  FermionicBasis both(3, 2, total_spin_filter(0) && first_orbital_empty);
+  FermionicBasis either(3, 2, total_spin_filter(0) || first_orbital_empty);
+  FermionicBasis neither(3, 2, !total_spin_filter(0) && !first_orbital_empty);
+
+  std::size_t both_count = 0;
+  std::size_t either_count = 0;
+  for (const BasisElement& element : all.elements()) {
+    const bool a = total_spin(element) == 0;
+    const bool b = first_orbital_empty(element);
+    EXPECT_EQ(both.contains(element), a && b);
+    EXPECT_EQ(either.contains(element), a || b);
+    EXPECT_EQ(neither.contains(element), !a && !b);
+    if (a && b) {
+      both_count++;
+    }
+    if (a || b) {
+      either_count++;
+    }
+  }
+  EXPECT_EQ(both.size(), both_count);
+  EXPECT_EQ(either.size(), either_count);
+  EXPECT_EQ(either.size() + neither.size(), all.size());
+}
+
+TEST(ElementFilterTest, RuntimeAdapter) {
+  BasisFilter* filter = make_basis_filter(total_spin_filter(0));
+  FermionicBasis adapted(4, 4, filter);
+  FermionicBasis expected(4, 4, new TotalSpinFilter(0));
+  EXPECT_EQ(adapted.elements(), expected.elements());
+}
+
+TEST(ReachableBasisTest, SeedsWithoutDynamics) {
+  Expression hamiltonian;
+  hamiltonian += density<Fermion>(1.0, Up, 0);
+  hamiltonian += density<Fermion>(1.0, Down, 1);
+
+  std::vector<BasisElement> seeds = {
+      {Operator::creation<Fermion>(Up, 1)},
+      {Operator::creation<Fermion>(Up, 0)},
+      {Operator::creation<Fermion>(Up, 1)}};
+  ReachableBasis basis(2, hamiltonian, seeds);
+
+  EXPECT_EQ(basis.particles(), 1);
+  EXPECT_THAT(
+      basis.elements(),
+      ElementsAre(
+          std::vector<Operator>{Operator::creation<Fermion>(Up, 0)},
+          std::vector<Operator>{Operator::creation<Fermion>(Up, 1)}));
+}
+
+TEST(ReachableBasisTest, HoppingConnectsSameSpinSector) {
+  Expression hamiltonian;
+  for (std::size_t i = 0; i < 3; i++) {
+    for (Operator::Spin spin : {Up, Down}) {
+      hamiltonian += hopping<Fermion>(-1.0, spin, i, (i + 1) % 3);
+    }
+  }
+
+  std::vector<BasisElement> seeds = {
+      {Operator::creation<Fermion>(Up, 0),
+       Operator::creation<Fermion>(Down, 0)}};
+  ReachableBasis basis(3, hamiltonian, seeds);
+
+  FermionicBasis expected(3, 2, new TotalSpinFilter(0));
+  EXPECT_EQ(basis.size(), expected.size());
+  EXPECT_EQ(basis.elements(), expected.elements());
+}
+
 TEST(PrepareUpAndDownRepresentationTest, EmptyElement) {
   BasisElement element;
   std::vector<int> up(5, 0);
@@ -252,3 +396,14 @@ TEST(StateStringTest, AllUpAndDown) {
   std::string actual_state = state_string(element, basis.orbitals());
   EXPECT_EQ(actual_state, expected_state);
 }
+
+TEST(OccupationBitsTest, RoundTrip) {
+  BasisElement element{
+      Operator::creation<Fermion>(Up, 0), Operator::creation<Fermion>(Down, 1),
+      Operator::creation<Fermion>(Up, 31)};
+  std::uint64_t bits = occupation_bits(element);
+  EXPECT_EQ(bits, (std::uint64_t{1} << 0) | (std::uint64_t{1} << 3) |
+                      (std::uint64_t{1} << 62));
+  EXPECT_EQ(element_from_occupation_bits(bits), element);
+  EXPECT_EQ(element_from_occupation_bits(0), BasisElement{});
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "CsrMatrix.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using testing::ElementsAre;
+
+static SparseMatrix<int> example_matrix() {
+  SparseMatrix<int> matrix;
+  matrix(0, 0) = 1;
+  matrix(0, 2) = 2;
+  matrix(2, 1) = 3;
+  matrix(1, 1) = 4;
+  matrix(2, 0) = 5;
+  return matrix;
+}
+
+TEST(CsrMatrixTest, DefaultConstructor) {
+  CsrMatrix<int> matrix;
+  EXPECT_EQ(matrix.rows(), 0);
+  EXPECT_EQ(matrix.nonzeros(), 0);
+  EXPECT_THAT(matrix.row_offsets(), ElementsAre(0));
+}
+
+TEST(CsrMatrixTest, FromSparseMatrix) {
+  CsrMatrix<int> matrix(3, 3, example_matrix());
+
+  EXPECT_EQ(matrix.nonzeros(), 5);
+  EXPECT_THAT(matrix.row_offsets(), ElementsAre(0, 2, 3, 5));
+  EXPECT_THAT(matrix.columns(), ElementsAre(0, 2, 1, 0, 1));
+  EXPECT_THAT(matrix.values(), ElementsAre(1, 2, 4, 5, 3));
+
+  EXPECT_EQ(matrix(0, 2), 2);
+  EXPECT_EQ(matrix(2, 0), 5);
+  EXPECT_EQ(matrix(1, 0), 0);
+}
+
+TEST(CsrMatrixTest, Multiply) {
+  CsrMatrix<int> matrix(3, 3, example_matrix());
+  std::vector<int> x = {1, 2, 3};
+  std::vector<int> y(3);
+  matrix.multiply(x, y);
+  EXPECT_THAT(y, ElementsAre(7, 8, 11));
+}
+
+TEST(CsrMatrixTest, EqualityOperator) {
+  CsrMatrix<int> matrix1(3, 3, example_matrix());
+  CsrMatrix<int> matrix2(3, 3, example_matrix());
+  CsrMatrix<int> matrix3(4, 3, example_matrix());
+
+  EXPECT_EQ(matrix1, matrix2);
+  EXPECT_NE(matrix1, matrix3);
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "DiagonalKernel.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <stdexcept>
+
+using enum Operator::Statistics;
+using enum Operator::Spin;
+
+// On-site U, chemical potential and nearest-neighbour Sz Sz on a ring.
+static Expression diagonal_terms(std::size_t size) {
+  Expression result;
+  for (std::size_t i = 0; i < size; i++) {
+    result += density_density<Fermion>(4.0, Up, i, Down, i);
+    for (Operator::Spin spin : {Up, Down}) {
+      result += density<Fermion>(-0.75, spin, i);
+    }
+    result += 0.25 * (spin_z(i) * spin_z((i + 1) % size));
+  }
+  result += 0.5;
+  return result;
+}
+
+TEST(DiagonalKernelTest, LevelsAgree) {
+  const std::size_t size = 12;
+  std::mt19937_64 rng(7);
+  std::vector<std::uint64_t> words(37);
+  for (std::uint64_t& word : words) {
+    word = rng() & ((std::uint64_t{1} << (2 * size)) - 1);
+  }
+
+  for (OccupationLayout layout :
+       {OccupationLayout::Interleaved, OccupationLayout::SpinBlocked}) {
+    Expression hamiltonian = diagonal_terms(size);
+    DiagonalOperator diagonal =
+        DiagonalOperator::split(hamiltonian, size, layout);
+    EXPECT_EQ(hamiltonian.size(), 0);
+
+    for (SimdLevel level :
+         {SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512}) {
+      if (level > simd_level()) {
+        continue;
+      }
+      // Every length up to the vector width, to cover the remainders.
+      for (std::size_t n : {0ul, 1ul, 3ul, 4ul, 7ul, 8ul, 9ul, 37ul}) {
+        std::vector<double> energies(n);
+        evaluate_diagonal(
+            diagonal, std::span(words).first(n), energies, level);
+        for (std::size_t i = 0; i < n; i++) {
+          EXPECT_NEAR(energies[i], diagonal(words[i]), 1e-12)
+              << simd_level_name(level) << " " << i;
+        }
+      }
+    }
+  }
+}
+
+TEST(DiagonalKernelTest, ParallelEvaluate) {
+  Expression hamiltonian = diagonal_terms(8);
+  DiagonalOperator diagonal = DiagonalOperator::split(hamiltonian, 8);
+  std::vector<std::uint64_t> words(10000);
+  for (std::size_t i = 0; i < words.size(); i++) {
+    words[i] = (i * 0x9e3779b97f4a7c15) >> 48;
+  }
+  std::vector<double> energies(words.size());
+  diagonal.evaluate(words, energies);
+  for (std::size_t i = 0; i < words.size(); i++) {
+    EXPECT_NEAR(energies[i], diagonal(words[i]), 1e-12);
+  }
+}
+
+TEST(DiagonalKernelTest, RejectsInvalidArguments) {
+  Expression hamiltonian = diagonal_terms(4);
+  DiagonalOperator diagonal = DiagonalOperator::split(hamiltonian, 4);
+  std::vector<std::uint64_t> words(8);
+  std::vector<double> energies(7);
+  EXPECT_THROW(
+      evaluate_diagonal(diagonal, words, energies, SimdLevel::Scalar),
+      std::invalid_argument);
+  EXPECT_THROW(diagonal.evaluate(words, energies), std::invalid_argument);
+
+  energies.resize(words.size());
+  for (SimdLevel level : {SimdLevel::Avx2, SimdLevel::Avx512}) {
+    if (level > simd_level()) {
+      EXPECT_THROW(
+          evaluate_diagonal(diagonal, words, energies, level),
+          std::invalid_argument)
+          << simd_level_name(level);
+    }
+  }
+}
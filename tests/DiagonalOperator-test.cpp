@@ -0,0 +1,94 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "DiagonalOperator.h"
+
+#include <gtest/gtest.h>
+
+#include "Basis.h"
+#include "FermionicBasis.h"
+
+using enum Operator::Statistics;
+using enum Operator::Spin;
+
+static Expression hubbard_chain(std::size_t size, double u, double mu) {
+  Expression result;
+  for (std::size_t i = 0; i < size; i++) {
+    for (Operator::Spin spin : {Up, Down}) {
+      result += density<Fermion>(-mu, spin, i);
+      result += hopping<Fermion>(-1.0, spin, i, (i + 1) % size);
+    }
+    result += density_density<Fermion>(u, Up, i, Down, i);
+  }
+  return result;
+}
+
+TEST(DiagonalOperatorTest, GroupsHubbardInteraction) {
+  Expression hamiltonian = hubbard_chain(4, 4.0, 0.0);
+  DiagonalOperator interleaved = DiagonalOperator::split(hamiltonian, 4);
+  ASSERT_EQ(interleaved.groups().size(), 1);
+  EXPECT_DOUBLE_EQ(interleaved.groups()[0].coefficient, 4.0);
+  EXPECT_EQ(interleaved.groups()[0].shift, 1);
+  EXPECT_EQ(interleaved.groups()[0].mask, 0b01010101);
+  // Only the hoppings are left.
+  EXPECT_EQ(hamiltonian.size(), 16);
+
+  Expression other = hubbard_chain(4, 4.0, 0.0);
+  DiagonalOperator blocked =
+      DiagonalOperator::split(other, 4, OccupationLayout::SpinBlocked);
+  ASSERT_EQ(blocked.groups().size(), 1);
+  EXPECT_EQ(blocked.groups()[0].shift, 4);
+  EXPECT_EQ(blocked.groups()[0].mask, 0b1111);
+}
+
+TEST(DiagonalOperatorTest, MatchesOperatorAlgebra) {
+  Expression hamiltonian = hubbard_chain(4, 3.0, 0.5);
+  hamiltonian += density_density<Fermion>(-2.0, Up, 0, Up, 2);
+  hamiltonian += 1.5;
+  Expression diagonal_terms = hamiltonian;
+  DiagonalOperator diagonal = DiagonalOperator::split(diagonal_terms, 4);
+
+  FermionicBasis basis(4, 4);
+  for (const BasisElement& element : basis.elements()) {
+    const std::uint64_t word = occupation_bits(element);
+    double expected = 0.0;
+    for (const auto& [operators, coefficient] : hamiltonian.terms()) {
+      auto result = apply_operators(operators, word);
+      if (result.has_value() && result->first == word) {
+        expected += result->second * coefficient.real();
+      }
+    }
+    EXPECT_DOUBLE_EQ(diagonal(word), expected);
+  }
+}
+
+TEST(DiagonalOperatorTest, NormalOrderedPairs) {
+  DiagonalOperator diagonal(2);
+  // c+(0) c+(1) c(1) c(0) = n(0) n(1) and c+(0) c+(1) c(0) c(1) = -n(0) n(1)
+  EXPECT_TRUE(diagonal.insert(
+      {Operator::creation<Fermion>(Up, 0), Operator::creation<Fermion>(Up, 1),
+       Operator::annihilation<Fermion>(Up, 1),
+       Operator::annihilation<Fermion>(Up, 0)},
+      2.0));
+  EXPECT_TRUE(diagonal.insert(
+      {Operator::creation<Fermion>(Up, 0), Operator::creation<Fermion>(Up, 1),
+       Operator::annihilation<Fermion>(Up, 0),
+       Operator::annihilation<Fermion>(Up, 1)},
+      0.5));
+  EXPECT_DOUBLE_EQ(diagonal(0b0101), 1.5);
+  EXPECT_DOUBLE_EQ(diagonal(0b0001), 0.0);
+}
+
+TEST(DiagonalOperatorTest, RejectsOtherTerms) {
+  DiagonalOperator diagonal(2);
+  EXPECT_FALSE(diagonal.insert(
+      one_body<Fermion>(1.0, Up, 0, Up, 1).operators(), 1.0));
+  EXPECT_FALSE(diagonal.insert(
+      density<Fermion>(1.0, Up, 0).operators(), {0.0, 1.0}));
+  // c(0) c+(0) = 1 - n(0) is not a plain density.
+  EXPECT_FALSE(diagonal.insert(
+      {Operator::annihilation<Fermion>(Up, 0),
+       Operator::creation<Fermion>(Up, 0)},
+      1.0));
+  EXPECT_TRUE(diagonal.empty());
+}
@@ -0,0 +1,140 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "DiskCache.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <complex>
+#include <filesystem>
+#include <fstream>
+
+#include "BasisFilter.h"
+#include "BosonicBasis.h"
+#include "FermionicBasis.h"
+#include "Models/LinearChain.h"
+#include "TemporaryPath.h"
+
+using enum Operator::Statistics;
+using enum Operator::Spin;
+
+TEST(DiskCacheTest, BasisRoundTrip) {
+  FermionicBasis basis(4, 3, new TotalSpinFilter(1));
+  const std::string path = temporary_path("basis.bin");
+  ASSERT_TRUE(save_basis(basis, path));
+
+  auto mapped = MappedBasis::open(path);
+  ASSERT_TRUE(mapped.has_value());
+  EXPECT_EQ(mapped->orbitals(), basis.orbitals());
+  EXPECT_EQ(mapped->particles(), basis.particles());
+  ASSERT_EQ(mapped->size(), basis.size());
+  for (std::size_t i = 0; i < basis.size(); i++) {
+    EXPECT_EQ(mapped->element(i), basis.element(i));
+    EXPECT_EQ(mapped->index(basis.element(i)), i);
+  }
+  EXPECT_FALSE(mapped->contains({Operator::creation<Fermion>(Up, 0)}));
+
+  std::filesystem::remove(path);
+}
+
+TEST(DiskCacheTest, UnsortedBasisRoundTrip) {
+  FermionicBasis basis(3, 2);
+  basis.sort(
+      [](const BasisElement& a, const BasisElement& b) { return b < a; });
+  const std::string path = temporary_path("basis.bin");
+  ASSERT_TRUE(save_basis(basis, path));
+
+  auto mapped = MappedBasis::open(path);
+  ASSERT_TRUE(mapped.has_value());
+  for (std::size_t i = 0; i < basis.size(); i++) {
+    EXPECT_EQ(mapped->index(basis.element(i)), i);
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST(DiskCacheTest, RejectsNonFermionicBasis) {
+  BosonicBasis basis(2, 2);
+  EXPECT_FALSE(save_basis(basis, temporary_path("basis.bin")));
+}
+
+TEST(DiskCacheTest, MatrixRoundTrip) {
+  auto model = LinearChain(4, 1.0, 2.0);
+  FermionicBasis basis(4, 2);
+  SparseMatrix<std::complex<double>> m;
+  model.compute_matrix_elements(basis, m);
+  CsrMatrix<std::complex<double>> matrix(basis.size(), basis.size(), m);
+
+  const std::string path = temporary_path("matrix.bin");
+  ASSERT_TRUE(save_matrix(matrix, path));
+
+  auto mapped = MappedCsrMatrix<std::complex<double>>::open(path);
+  ASSERT_TRUE(mapped.has_value());
+  EXPECT_EQ(mapped->rows(), matrix.rows());
+  EXPECT_EQ(mapped->cols(), matrix.cols());
+  EXPECT_TRUE(std::ranges::equal(mapped->row_offsets(), matrix.row_offsets()));
+  EXPECT_TRUE(std::ranges::equal(mapped->columns(), matrix.columns()));
+  EXPECT_TRUE(std::ranges::equal(mapped->values(), matrix.values()));
+
+  EXPECT_FALSE(MappedCsrMatrix<double>::open(path).has_value());
+
+  std::filesystem::remove(path);
+}
+
+// Overwrites the bytes at `offset` of a file with those of `value`.
+template <typename T>
+static void patch(const std::string& path, std::size_t offset, T value) {
+  std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+  file.seekp(static_cast<std::streamoff>(offset));
+  file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+TEST(DiskCacheTest, RejectsCorruptIndices) {
+  auto model = LinearChain(4, 1.0, 2.0);
+  FermionicBasis basis(4, 2);
+  SparseMatrix<std::complex<double>> m;
+  model.compute_matrix_elements(basis, m);
+  CsrMatrix<std::complex<double>> matrix(basis.size(), basis.size(), m);
+  using Mapped = MappedCsrMatrix<std::complex<double>>;
+
+  // The header is 48 bytes, with the rows at 24 and the nonzeros at 40,
+  // and is followed by the row offsets and the columns.
+  const std::size_t offsets_at = 48;
+  const std::size_t columns_at = offsets_at + 8 * (matrix.rows() + 1);
+  const std::string path = temporary_path("matrix.bin");
+  auto corrupt = [&](std::size_t offset, std::uint64_t value) {
+    EXPECT_TRUE(save_matrix(matrix, path));
+    patch(path, offset, value);
+    return !Mapped::open(path).has_value();
+  };
+  EXPECT_TRUE(corrupt(24, ~std::uint64_t{0}));
+  EXPECT_TRUE(corrupt(40, std::uint64_t{1} << 62));
+  EXPECT_TRUE(corrupt(offsets_at + 8, matrix.nonzeros() + 1));
+  EXPECT_TRUE(corrupt(offsets_at + 8 * matrix.rows(), 0));
+  ASSERT_TRUE(save_matrix(matrix, path));
+  patch(path, columns_at, static_cast<std::uint32_t>(matrix.cols()));
+  EXPECT_FALSE(Mapped::open(path).has_value());
+
+  // An unsorted basis stores the permutation that sorts it after the words.
+  basis.sort(
+      [](const BasisElement& a, const BasisElement& b) { return b < a; });
+  ASSERT_TRUE(save_basis(basis, path));
+  patch(path, 48 + 8 * basis.size(), std::uint64_t{basis.size()});
+  EXPECT_FALSE(MappedBasis::open(path).has_value());
+  ASSERT_TRUE(save_basis(basis, path));
+  patch(path, 32, std::uint64_t{1} << 61);
+  EXPECT_FALSE(MappedBasis::open(path).has_value());
+
+  std::filesystem::remove(path);
+}
+
+TEST(DiskCacheTest, RejectsInvalidFiles) {
+  const std::string path = temporary_path("invalid.bin");
+  std::ofstream(path) << "definitely not a cache file";
+  EXPECT_FALSE(MappedBasis::open(path).has_value());
+  EXPECT_FALSE(MappedCsrMatrix<double>::open(path).has_value());
+  std::filesystem::remove(path);
+
+  EXPECT_FALSE(MappedBasis::open(path).has_value());
+}
@@ -8,6 +8,10 @@
 
 #include <vector>
 
+#include "ExpressionTemplates.h"
+#include "NormalOrderer.h"
+#include "TaskScheduler.h"
+
 using testing::IsEmpty;
 
 using enum Operator::Type;
@@ -131,6 +135,147 @@ TEST(ExpressionTest, InequalityOperator) {
   EXPECT_NE(expression1, expression4);
 }
 
+TEST(ExpressionTest, LazyMatchesEager) {
+  const double j = 0.7;
+  Expression eager;
+  Expression result;
+  for (std::size_t i = 0; i < 4; i++) {
+    eager += -0.5 * spin_z(i);
+    result += -0.5 * lazy(spin_z(i));
+    eager += j * spin_x(i) * spin_x((i + 1) % 4);
+    result += j * lazy(spin_x(i)) * lazy(spin_x((i + 1) % 4));
+    eager += j * spin_y(i) * spin_y((i + 1) % 4);
+    result += j * lazy(spin_y(i)) * lazy(spin_y((i + 1) % 4));
+  }
+  EXPECT_EQ(result, eager);
+}
+
+TEST(ExpressionTest, LazyOperands) {
+  Term a = one_body<Fermion>(2.0, Up, 0, Up, 1);
+  Term b = density<Fermion>(-1.0, Down, 2);
+  Expression c = spin_z(3);
+
+  Expression sum = lazy(a) + b + c;
+  Expression expected = add(a, b) + c;
+  EXPECT_EQ(sum, expected);
+
+  Expression product = (lazy(a) + b) * c * 3.0;
+  EXPECT_EQ(product, (add(a, b) * c).product(3.0));
+
+  // Operators shared by two terms of the product are accumulated.
+  Expression square = lazy(c) * c;
+  EXPECT_EQ(square, c * c);
+}
+
+TEST(ExpressionTest, RvalueOverloadsMatchCopies) {
+  Term a = one_body<Fermion>(2.0, Up, 0, Up, 1);
+  Term b = density<Fermion>(-1.0, Down, 2);
+  Expression c = spin_z(3);
+  Expression d = spin_x(1);
+  // Temporaries, so that the && overloads are picked.
+  auto copy = [](const auto& x) { return x; };
+
+  EXPECT_EQ(copy(a).product(b).negate(), a.product(b).negate());
+  EXPECT_EQ(copy(a).adjoint(), a.adjoint());
+  EXPECT_EQ(copy(c).product(d).negate(), c.product(d).negate());
+  EXPECT_EQ(copy(c).adjoint(), c.adjoint());
+  EXPECT_EQ(copy(c).product(2.5), c.product(2.5));
+  EXPECT_EQ(copy(c) + d, c + d);
+
+  Expression sum = c;
+  sum += copy(d);
+  sum += copy(a);
+  EXPECT_EQ(sum, c + d + a);
+
+  const Expression cd = c.product(d);
+  EXPECT_EQ(
+      NormalOrderer(copy(cd)).expression(), NormalOrderer(cd).expression());
+}
+
+// Big enough for the parallel path of Expression::product().
+static Expression large_chain() {
+  Expression result;
+  for (std::size_t i = 0; i < 32; i++) {
+    result += spin_x(i) * spin_x((i + 1) % 32);
+    result += spin_z(i) * spin_z((i + 1) % 32);
+    result += hopping<Fermion>(2.0, Down, i, (i + 3) % 32);
+  }
+  return result;
+}
+
+TEST(ExpressionTest, ParallelProductMatchesSerial) {
+  const Expression h = large_chain();
+  const std::size_t pairs = h.size() * h.size();
+  TaskScheduler serial(1);
+  TaskScheduler parallel(4);
+  ASSERT_EQ(Expression::product_chunks(pairs, serial), 1);
+  ASSERT_EQ(Expression::product_chunks(pairs, parallel), 4);
+
+  Expression expected;
+  for (const auto& [operators, coefficient] : h.terms()) {
+    expected += h.product(Term(coefficient, operators));
+  }
+  EXPECT_EQ(h.product(h, serial), expected);
+  EXPECT_EQ(h.product(h, parallel), expected);
+  EXPECT_EQ(h * h, expected);
+}
+
+TEST(ExpressionTest, Sum) {
+  const Expression a = spin_x(0);
+  const Expression b = spin_z(0) + spin_y(1);
+  EXPECT_EQ(sum({a, Expression(), b, a}), a + b + a);
+  EXPECT_EQ(sum({b}), b);
+  EXPECT_THAT(sum({}).terms(), IsEmpty());
+
+  // Every term in two of the parts, summed over four shards.
+  TaskScheduler scheduler(4);
+  const Expression chain = large_chain();
+  std::vector<Expression> parts(6);
+  std::size_t k = 0;
+  for (const auto& [operators, coefficient] : chain.terms()) {
+    parts[k % parts.size()] += Term(coefficient, operators);
+    parts[(k + 1) % parts.size()] += Term(coefficient, operators);
+    k++;
+  }
+  EXPECT_EQ(sum(parts, scheduler), 2.0 * chain);
+}
+
+TEST(ExpressionTest, Tolerance) {
+  const Term a = one_body<Fermion>(1.0, Up, 0, Up, 1);
+  const Term small = one_body<Fermion>(1e-9, Up, 1, Up, 0);
+  const Term minus_a = one_body<Fermion>(-1.0, Up, 0, Up, 1);
+
+  Expression exact;
+  exact += a;
+  exact += small;
+  exact += minus_a;
+  EXPECT_EQ(exact.size(), 2);
+  EXPECT_EQ(exact.discarded(), 0.0);
+
+  Expression truncated;
+  truncated.set_tolerance(1e-6);
+  truncated += a;
+  truncated += small;
+  EXPECT_EQ(truncated.size(), 1);
+  truncated += minus_a;
+  EXPECT_THAT(truncated.terms(), IsEmpty());
+  EXPECT_DOUBLE_EQ(truncated.discarded(), 1e-9);
+
+  // Setting a tolerance prunes, scaling down scales what was discarded and
+  // drops what falls below it, and products keep the larger tolerance.
+  exact += Term(2.0, {});
+  exact.set_tolerance(1e-6);
+  EXPECT_EQ(exact, Expression({Term(2.0, {})}));
+  exact *= 1e-7;
+  EXPECT_THAT(exact.terms(), IsEmpty());
+  EXPECT_DOUBLE_EQ(exact.discarded(), 1e-9 * 1e-7 + 2e-7);
+
+  Expression c = spin_x(0);
+  EXPECT_EQ(c.product(truncated).tolerance(), 1e-6);
+  EXPECT_EQ(c.product(truncated).discarded(), 0.0);
+  EXPECT_DOUBLE_EQ(sum({c, truncated}).discarded(), 1e-9);
+}
+
 TEST(NormalOrderTest, ExpressionResultingInZero) {
   std::vector<Term> terms = {
       Term(
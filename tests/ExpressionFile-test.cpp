@@ -0,0 +1,155 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "ExpressionFile.h"
+
+#include <gtest/gtest.h>
+
+#include <complex>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "TemporaryPath.h"
+
+using enum Operator::Statistics;
+using enum Operator::Spin;
+
+static Expression test_expression() {
+  Expression result;
+  for (std::size_t i = 0; i < 4; i++) {
+    result += hopping<Fermion>(0.5, Up, i, i + 1);
+    result += spin_z(i) * spin_z(i + 1);
+  }
+  result.insert(Term(2.0, {}));
+  result *= std::complex<double>(1.0, -0.5);
+  return result;
+}
+
+TEST(ExpressionFileTest, StreamRoundTrip) {
+  const Expression expression = test_expression();
+  std::stringstream stream;
+  ASSERT_TRUE(write_expression(stream, expression));
+  auto read = read_expression(stream);
+  ASSERT_TRUE(read.has_value());
+  EXPECT_EQ(*read, expression);
+
+  std::stringstream empty;
+  ASSERT_TRUE(write_expression(empty, Expression()));
+  read = read_expression(empty);
+  ASSERT_TRUE(read.has_value());
+  EXPECT_EQ(read->size(), 0);
+}
+
+TEST(ExpressionFileTest, TermRoundTrip) {
+  const Term term = density<Fermion>(std::complex<double>(1.0, -2.0), Down, 3);
+  std::stringstream stream;
+  ASSERT_TRUE(write_term(stream, term));
+  auto read = read_term(stream);
+  ASSERT_TRUE(read.has_value());
+  EXPECT_EQ(*read, term);
+
+  std::stringstream expression;
+  ASSERT_TRUE(write_expression(expression, test_expression()));
+  EXPECT_FALSE(read_term(expression).has_value());
+}
+
+TEST(ExpressionFileTest, MappedRoundTrip) {
+  const Expression expression = test_expression();
+  const std::string path = temporary_path("expression.bin");
+  ASSERT_TRUE(save_expression(expression, path));
+
+  auto loaded = load_expression(path);
+  ASSERT_TRUE(loaded.has_value());
+  EXPECT_EQ(*loaded, expression);
+
+  auto mapped = MappedExpression::open(path);
+  ASSERT_TRUE(mapped.has_value());
+  ASSERT_EQ(mapped->size(), expression.size());
+  for (std::size_t i = 0; i + 1 < mapped->size(); i++) {
+    const auto a = mapped->operators(i);
+    const auto b = mapped->operators(i + 1);
+    EXPECT_TRUE(
+        std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end()));
+  }
+  for (const auto& [operators, coefficient] : expression.terms()) {
+    EXPECT_EQ(mapped->find(operators), coefficient);
+  }
+  EXPECT_FALSE(
+      mapped->find(std::vector{Operator::creation<Boson>(Up, 0)}).has_value());
+  EXPECT_EQ(mapped->expression(), expression);
+  std::filesystem::remove(path);
+}
+
+TEST(ExpressionFileTest, RejectsInvalidFiles) {
+  const std::string path = temporary_path("invalid.bin");
+  std::ofstream(path) << "definitely not an expression file";
+  EXPECT_FALSE(load_expression(path).has_value());
+  EXPECT_FALSE(MappedExpression::open(path).has_value());
+  std::filesystem::remove(path);
+
+  std::stringstream stream;
+  ASSERT_TRUE(write_expression(stream, test_expression()));
+  std::string truncated = stream.str();
+  truncated.pop_back();
+  std::stringstream truncated_stream(truncated);
+  EXPECT_FALSE(read_expression(truncated_stream).has_value());
+  EXPECT_FALSE(load_expression(temporary_path("missing.bin")));
+}
+
+TEST(ExpressionFileTest, RejectsCorruptCounts) {
+  std::stringstream stream;
+  ASSERT_TRUE(write_expression(stream, test_expression()));
+  const std::string valid = stream.str();
+  const std::string path = temporary_path("corrupt.bin");
+
+  // Term counts that would wrap the offsets or overflow the array sizes,
+  // and operator counts beyond the end of the data.
+  constexpr std::size_t terms_at = 16;
+  constexpr std::size_t operators_at = 24;
+  const std::vector<std::pair<std::size_t, std::uint64_t>> corruptions = {
+      {terms_at, ~std::uint64_t{0}},
+      {terms_at, std::uint64_t{1} << 60},
+      {operators_at, ~std::uint64_t{0}},
+      {operators_at, std::uint64_t{1} << 62}};
+  for (const auto& [offset, value] : corruptions) {
+    std::string corrupt = valid;
+    std::memcpy(corrupt.data() + offset, &value, sizeof(value));
+    std::stringstream corrupt_stream(corrupt);
+    EXPECT_FALSE(read_expression(corrupt_stream).has_value());
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << corrupt;
+    EXPECT_FALSE(MappedExpression::open(path).has_value());
+    EXPECT_FALSE(load_expression(path).has_value());
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(ExpressionFileTest, RejectsUnsortedTerms) {
+  // Two terms of two operators each, whose operators start after the
+  // header, two coefficients and three offsets.
+  const Expression expression(std::vector<Term>{
+      density<Fermion>(1.0, Up, 0), density<Fermion>(2.0, Up, 1)});
+  std::stringstream stream;
+  ASSERT_TRUE(write_expression(stream, expression));
+  const std::string valid = stream.str();
+  constexpr std::size_t operators_at = 32 + 2 * 16 + 3 * 8;
+  ASSERT_EQ(valid.size(), operators_at + 4);
+
+  std::string repeated = valid;
+  repeated.replace(operators_at + 2, 2, valid, operators_at, 2);
+  std::string swapped = valid;
+  swapped.replace(operators_at, 2, valid, operators_at + 2, 2);
+  swapped.replace(operators_at + 2, 2, valid, operators_at, 2);
+
+  const std::string path = temporary_path("unsorted.bin");
+  for (const std::string& corrupt : {repeated, swapped}) {
+    std::stringstream corrupt_stream(corrupt);
+    EXPECT_FALSE(read_expression(corrupt_stream).has_value());
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << corrupt;
+    EXPECT_FALSE(MappedExpression::open(path).has_value());
+  }
+  std::filesystem::remove(path);
+}
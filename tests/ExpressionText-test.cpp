@@ -0,0 +1,76 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "ExpressionText.h"
+
+#include <gtest/gtest.h>
+
+#include <complex>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "TemporaryPath.h"
+
+using enum Operator::Statistics;
+using enum Operator::Spin;
+
+TEST(ExpressionTextTest, Parse) {
+  const auto expression = parse_expression(
+      "# Hopping between orbitals 0 and 1\n"
+      "-1 c+0u c1u\n"
+      "\n"
+      "  -1\tc+1u c0u  \r\n"
+      "(0.5,-0.25) b+3d b3d\n"
+      "0.25 b+3d b3d\n"
+      "2");
+  ASSERT_TRUE(expression.has_value());
+
+  Expression expected;
+  expected += hopping<Fermion>(-1.0, Up, 0, 1);
+  expected.insert(
+      Term(std::complex<double>(0.75, -0.25),
+           {Operator::creation<Boson>(Down, 3),
+            Operator::annihilation<Boson>(Down, 3)}));
+  expected.insert(Term(2.0, {}));
+  EXPECT_EQ(*expression, expected);
+
+  EXPECT_EQ(parse_expression("")->size(), 0);
+  EXPECT_EQ(parse_expression("# nothing\n\n")->size(), 0);
+}
+
+TEST(ExpressionTextTest, RejectsMalformedLines) {
+  EXPECT_FALSE(parse_expression("c+0u c1u").has_value());
+  EXPECT_FALSE(parse_expression("1 c+0x").has_value());
+  EXPECT_FALSE(parse_expression("1 f+0u").has_value());
+  EXPECT_FALSE(parse_expression("1 c+u").has_value());
+  EXPECT_FALSE(parse_expression("1 c+32u").has_value());
+  EXPECT_FALSE(parse_expression("1 c+0uc1u").has_value());
+  EXPECT_FALSE(parse_expression("1x c+0u").has_value());
+  EXPECT_FALSE(parse_expression("(1,2 c+0u").has_value());
+  EXPECT_FALSE(parse_expression("1 c+0u\n2 c+1q\n").has_value());
+}
+
+TEST(ExpressionTextTest, RoundTrip) {
+  Expression expression;
+  for (std::size_t i = 0; i < 4; i++) {
+    const double t = 0.1 * static_cast<double>(i + 1);
+    expression += hopping<Fermion>(t, Up, i, i + 1);
+    expression += spin_z(i) * spin_z(i + 1);
+  }
+  expression *= std::complex<double>(1.0 / 3.0, -0.7);
+
+  const std::string path = temporary_path("expression.txt");
+  {
+    std::ofstream out(path);
+    ASSERT_TRUE(write_expression_text(out, expression));
+  }
+  const auto loaded = load_expression_text(path);
+  ASSERT_TRUE(loaded.has_value());
+  EXPECT_EQ(*loaded, expression);
+
+  std::ofstream(path, std::ios::trunc).close();
+  EXPECT_EQ(load_expression_text(path)->size(), 0);
+  std::filesystem::remove(path);
+  EXPECT_FALSE(load_expression_text(path).has_value());
+}
@@ -0,0 +1,165 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "Fcidump.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <complex>
+#include <sstream>
+
+#include "FermionicBasis.h"
+#include "Models/MolecularModel.h"
+#include "NormalOrderer.h"
+#include "SparseMatrix.h"
+
+using enum Operator::Statistics;
+using enum Operator::Spin;
+
+// An arbitrary value for each class of equivalent integrals.
+static double integral(
+    std::size_t i, std::size_t j, std::size_t k, std::size_t l) {
+  const std::pair ij(std::min(i, j), std::max(i, j));
+  const std::pair kl(std::min(k, l), std::max(k, l));
+  const std::pair first = std::min(ij, kl);
+  const std::pair second = std::max(ij, kl);
+  return 0.1 * static_cast<double>(
+                   1 + first.first + 2 * first.second + 3 * second.first +
+                   5 * second.second);
+}
+
+static double one_body_integral(std::size_t i, std::size_t j) {
+  return -1.0 + 0.3 * static_cast<double>(i + j);
+}
+
+// Every unique integral of `n` orbitals once, with 1-based indices.
+static std::string fcidump_text(std::size_t n) {
+  std::ostringstream out;
+  out << " &FCI NORB=" << n << ",NELEC=2,MS2=0,\n";
+  out << "  ORBSYM=" << std::string(2 * n, ',') << "\n  ISYM=1,\n &END\n";
+  for (std::size_t i = 0; i < n; i++) {
+    for (std::size_t j = 0; j <= i; j++) {
+      for (std::size_t k = 0; k < n; k++) {
+        for (std::size_t l = 0; l <= k; l++) {
+          if (i * (i + 1) / 2 + j >= k * (k + 1) / 2 + l) {
+            out << integral(i, j, k, l) << ' ' << i + 1 << ' ' << j + 1
+                << ' ' << k + 1 << ' ' << l + 1 << '\n';
+          }
+        }
+      }
+    }
+  }
+  for (std::size_t i = 0; i < n; i++) {
+    for (std::size_t j = 0; j <= i; j++) {
+      out << one_body_integral(i, j) << ' ' << i + 1 << ' ' << j + 1
+          << " 0 0\n";
+    }
+  }
+  out << "0.5 0 0 0 0\n";
+  return out.str();
+}
+
+TEST(FcidumpTest, Parse) {
+  const auto integrals = parse_fcidump(
+      " &FCI NORB=  2,NELEC= 2,MS2= 0,\n"
+      "  ORBSYM=1,1,\n"
+      "  ISYM=1,\n"
+      " /\n"
+      "  0.675D+00  1  1  1  1\n"
+      "  0.1 2 1 1 1\n"
+      "  0.1 1 1 1 2\n"
+      "  1.0e-20 2 1 2 1\n"
+      "  0.0 2 2 1 1\n"
+      "  -1.25 1 2 0 0\n"
+      "  -0.5 1 0 0 0\n"
+      "  0.7 0 0 0 0\n",
+      1e-12);
+  ASSERT_TRUE(integrals.has_value());
+  EXPECT_EQ(integrals->orbitals, 2);
+  EXPECT_EQ(integrals->electrons, 2);
+  EXPECT_EQ(integrals->ms2, 0);
+  EXPECT_EQ(integrals->core_energy, 0.7);
+
+  ASSERT_EQ(integrals->one_body.size(), 1);
+  EXPECT_EQ(integrals->one_body[0].i, 1);
+  EXPECT_EQ(integrals->one_body[0].j, 0);
+  EXPECT_EQ(integrals->one_body[0].value, -1.25);
+
+  // (21|11) and (11|12) are the same integral, and the rest is negligible.
+  ASSERT_EQ(integrals->two_body.size(), 2);
+  EXPECT_EQ(integrals->two_body[0].indices, (std::array<std::size_t, 4>{}));
+  EXPECT_EQ(integrals->two_body[0].value, 0.675);
+  EXPECT_EQ(
+      integrals->two_body[1].indices, (std::array<std::size_t, 4>{1, 0, 0, 0}));
+  EXPECT_EQ(integrals->two_body[1].value, 0.1);
+}
+
+TEST(FcidumpTest, RejectsInvalidFiles) {
+  EXPECT_FALSE(parse_fcidump("0.1 1 1 1 1\n").has_value());
+  EXPECT_FALSE(parse_fcidump("&FCI NELEC=2 &END\n").has_value());
+  EXPECT_FALSE(parse_fcidump("&FCI NORB=33 &END\n").has_value());
+  EXPECT_FALSE(parse_fcidump("&FCI NORB=2 &END\n0.1 1 3 0 0\n").has_value());
+  EXPECT_FALSE(parse_fcidump("&FCI NORB=2 &END\n0.1 1 1 1\n").has_value());
+  EXPECT_FALSE(parse_fcidump("&FCI NORB=2 &END\n0.1 0 1 0 0\n").has_value());
+  EXPECT_FALSE(parse_fcidump("&FCI NORB=2 &END\n0.1 1 1 1 0\n").has_value());
+  EXPECT_FALSE(parse_fcidump("&FCI NORB=2 &END\nx 1 1 1 1\n").has_value());
+  EXPECT_TRUE(parse_fcidump("&FCI NORB=2 &END\n").has_value());
+}
+
+TEST(FcidumpTest, HamiltonianMatchesFullSum) {
+  const std::size_t n = 3;
+  const auto integrals = parse_fcidump(fcidump_text(n));
+  ASSERT_TRUE(integrals.has_value());
+  EXPECT_EQ(integrals->one_body.size(), n * (n + 1) / 2);
+  const std::size_t pairs = n * (n + 1) / 2;
+  EXPECT_EQ(integrals->two_body.size(), pairs * (pairs + 1) / 2);
+
+  // E + sum h_pq c+(p,s) c(q,s)
+  //   + 1/2 sum (pq|rs) c+(p,s) c+(r,t) c(s,t) c(q,s), over all indices.
+  Expression expected({Term(0.5, {})});
+  for (std::size_t p = 0; p < n; p++) {
+    for (std::size_t q = 0; q < n; q++) {
+      for (Operator::Spin s1 : {Up, Down}) {
+        expected += one_body<Fermion>(one_body_integral(p, q), s1, p, s1, q);
+        for (std::size_t r = 0; r < n; r++) {
+          for (std::size_t s = 0; s < n; s++) {
+            for (Operator::Spin s2 : {Up, Down}) {
+              expected += Term(
+                  0.5 * integral(p, q, r, s),
+                  {Operator::creation<Fermion>(s1, p),
+                   Operator::creation<Fermion>(s2, r),
+                   Operator::annihilation<Fermion>(s2, s),
+                   Operator::annihilation<Fermion>(s1, q)});
+            }
+          }
+        }
+      }
+    }
+  }
+
+  NormalOrderer difference(1e-12);
+  difference.insert(molecular_hamiltonian(*integrals));
+  difference.insert(expected.negate());
+  // Terms that vanish by the exclusion principle are not simplified, and
+  // are left out.
+  for (const auto& [operators, coefficient] : difference.terms()) {
+    EXPECT_NE(std::ranges::adjacent_find(operators), operators.end());
+  }
+}
+
+TEST(FcidumpTest, MolecularModel) {
+  // One orbital: H = e (n_up + n_down) + U n_up n_down.
+  auto integrals = parse_fcidump(
+      "&FCI NORB=1,NELEC=2,MS2=0 &END\n"
+      "4.0 1 1 1 1\n"
+      "-1.5 1 1 0 0\n"
+      "0.25 0 0 0 0\n");
+  ASSERT_TRUE(integrals.has_value());
+  MolecularModel model(std::move(*integrals));
+  FermionicBasis basis(1, 2, /*allow_double_occupancy=*/true);
+  ASSERT_EQ(basis.size(), 1);
+  SparseMatrix<std::complex<double>> m;
+  model.compute_matrix_elements(basis, m);
+  EXPECT_NEAR(std::abs(m(0, 0) - (0.25 + 2.0 * -1.5 + 4.0)), 0.0, 1e-12);
+}
@@ -0,0 +1,115 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "GrandCanonicalBuilder.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "BasisFilter.h"
+#include "FermionicBasis.h"
+#include "Models/HubbardChain.h"
+#include "SparseMatrix.h"
+
+using enum Operator::Statistics;
+using enum Operator::Spin;
+
+using Coeff = Term::CoeffType;
+
+TEST(GrandCanonicalBuilderTest, Sectors) {
+  HubbardChain model(0.5, 1.0, 4.0, 4);
+  auto blocks = model.sector_blocks(4, {0, 2, 3});
+  // N = 0: one state. N = 2: spins -2, 0, 2. N = 3: spins -3, -1, 1, 3.
+  ASSERT_EQ(blocks.size(), 8);
+  std::size_t offset = 0;
+  for (const SectorBlock& block : blocks) {
+    EXPECT_EQ(block.offset, offset);
+    EXPECT_EQ(block.matrix.rows(), block.states.size());
+    EXPECT_TRUE(std::is_sorted(block.states.begin(), block.states.end()));
+    offset += block.states.size();
+  }
+  EXPECT_EQ(offset, 1 + 28 + 56);
+  EXPECT_EQ(blocks[0].particles, 0);
+  EXPECT_EQ(blocks[2].particles, 2);
+  EXPECT_EQ(blocks[2].total_spin, 0);
+  EXPECT_EQ(blocks[2].states.size(), 16);
+
+  // Repeated and unsorted particle numbers give the same blocks.
+  auto repeated = model.sector_blocks(4, {3, 2, 0, 2, 3});
+  ASSERT_EQ(repeated.size(), blocks.size());
+  for (std::size_t k = 0; k < blocks.size(); k++) {
+    EXPECT_EQ(repeated[k].particles, blocks[k].particles);
+    EXPECT_EQ(repeated[k].offset, blocks[k].offset);
+    EXPECT_EQ(repeated[k].states, blocks[k].states);
+  }
+
+  auto only = model.sector_blocks(4, {3}, 1);
+  ASSERT_EQ(only.size(), 1);
+  EXPECT_EQ(only[0].total_spin, 1);
+  EXPECT_EQ(only[0].offset, 0);
+}
+
+TEST(GrandCanonicalBuilderTest, RejectsUnsupportedTerms) {
+  // A spin flip, a pair creation, a boson and an orbital out of range.
+  const std::vector<Expression> unsupported = {
+      Expression({one_body<Fermion>(1.0, Up, 0, Down, 1)}),
+      Expression({Term(
+          1.0, {Operator::creation<Fermion>(Up, 0),
+                Operator::creation<Fermion>(Down, 1)})}),
+      Expression({density<Boson>(1.0, Up, 0)}),
+      hopping<Fermion>(1.0, Up, 0, 4),
+  };
+  for (const Expression& hamiltonian : unsupported) {
+    EXPECT_THROW(
+        GrandCanonicalBuilder(4, hamiltonian), std::invalid_argument);
+  }
+  EXPECT_THROW(GrandCanonicalBuilder(33, Expression()), std::invalid_argument);
+
+  GrandCanonicalBuilder builder(
+      2, Expression({hopping<Fermion>(1.0, Up, 0, 1)}));
+  EXPECT_THROW(builder.build({5}), std::invalid_argument);
+}
+
+TEST(GrandCanonicalBuilderTest, SameBlocksAsFermionicBasis) {
+  HubbardChain model(0.5, 1.0, 4.0, 5);
+  auto blocks = model.sector_blocks(5, {2, 3, 4, 5});
+  for (const SectorBlock& block : blocks) {
+    FermionicBasis basis(
+        5, block.particles, new TotalSpinFilter(block.total_spin));
+    ASSERT_EQ(basis.size(), block.states.size());
+    // Row of the block of every state of the basis.
+    std::vector<std::size_t> rows(basis.size());
+    for (std::size_t i = 0; i < basis.size(); i++) {
+      const std::uint64_t word = occupation_bits(basis.element(i));
+      auto it =
+          std::lower_bound(block.states.begin(), block.states.end(), word);
+      ASSERT_TRUE(it != block.states.end() && *it == word);
+      rows[i] = static_cast<std::size_t>(it - block.states.begin());
+    }
+
+    // Both matrices densely, in the order of the block.
+    const std::size_t size = basis.size();
+    std::vector<Coeff> actual(size * size);
+    const auto offsets = block.matrix.row_offsets();
+    const auto columns = block.matrix.columns();
+    const auto values = block.matrix.values();
+    for (std::size_t i = 0; i < size; i++) {
+      for (std::size_t k = offsets[i]; k < offsets[i + 1]; k++) {
+        actual[i * size + columns[k]] += values[k];
+      }
+    }
+    SparseMatrix<Coeff> elements;
+    model.compute_matrix_elements(basis, elements);
+    std::vector<Coeff> expected(size * size);
+    for (const auto& [index, value] : elements.elements()) {
+      expected[rows[index.i] * size + rows[index.j]] += value;
+    }
+    for (std::size_t k = 0; k < actual.size(); k++) {
+      EXPECT_NEAR(std::abs(actual[k] - expected[k]), 0.0, 1e-12)
+          << "N = " << block.particles << ", element " << k / size << ", "
+          << k % size;
+    }
+  }
+}
@@ -0,0 +1,158 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "HubbardEngine.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <functional>
+#include <stdexcept>
+
+#include "BasisFilter.h"
+#include "FermionicBasis.h"
+#include "Models/HubbardChain.h"
+#include "SparseMatrix.h"
+
+using testing::ElementsAre;
+
+using Coeff = HubbardEngine::Coeff;
+using Apply = std::function<void(std::span<const Coeff>, std::span<Coeff>)>;
+
+// tr(H), tr(H^2) and tr(H^3) from products with the unit vectors. They do
+// not depend on the signs (or order) of the basis states.
+static std::array<Coeff, 3> moments(std::size_t size, const Apply& apply) {
+  std::array<Coeff, 3> result = {};
+  std::vector<Coeff> x(size);
+  std::vector<Coeff> y(size);
+  for (std::size_t i = 0; i < size; i++) {
+    std::fill(x.begin(), x.end(), Coeff(0.0));
+    x[i] = 1.0;
+    for (Coeff& moment : result) {
+      apply(x, y);
+      moment += y[i];
+      std::swap(x, y);
+    }
+  }
+  return result;
+}
+
+TEST(HubbardEngineTest, SpinlessStates) {
+  HubbardEngine engine(4, 2, 1, Expression());
+  EXPECT_THAT(
+      engine.up_states(),
+      ElementsAre(0b0011, 0b0101, 0b0110, 0b1001, 0b1010, 0b1100));
+  EXPECT_THAT(
+      engine.down_states(), ElementsAre(0b0001, 0b0010, 0b0100, 0b1000));
+  EXPECT_EQ(engine.size(), 24);
+  // Up electrons on orbitals 0 and 1, down electron on orbital 2.
+  EXPECT_EQ(engine.word(2), 0b100101);
+}
+
+TEST(HubbardEngineTest, HoppingSign) {
+  // c+(2) c(0) on |0, 1> passes the electron on orbital 1.
+  Expression hamiltonian;
+  hamiltonian += one_body<Fermion>(1.0, Up, 2, Up, 0);
+  HubbardEngine engine(3, 2, 0, hamiltonian);
+  EXPECT_EQ(engine.up_hopping()(2, 0), Coeff(-1.0));
+  EXPECT_EQ(engine.up_hopping().nonzeros(), 1);
+}
+
+TEST(HubbardEngineTest, Diagonal) {
+  Expression hamiltonian;
+  hamiltonian += density_density<Fermion>(4.0, Up, 0, Down, 0);
+  hamiltonian += density<Fermion>(-1.0, Down, 1);
+  HubbardEngine engine(2, 1, 1, hamiltonian);
+  // |up on 0, down on 0>, |0, 1>, |1, 0>, |1, 1>
+  EXPECT_THAT(engine.diagonal(), ElementsAre(4.0, -1.0, 0.0, -1.0));
+}
+
+TEST(HubbardEngineTest, SameSpectrumAsFermionicBasis) {
+  auto model = HubbardChain(0.5, 1.0, 4.0, 4);
+  HubbardEngine engine = model.hubbard_engine(4, 1, 2);
+
+  FermionicBasis basis(4, 3, new TotalSpinFilter(1));
+  ASSERT_EQ(engine.size(), basis.size());
+  SparseMatrix<Coeff> elements;
+  model.compute_matrix_elements(basis, elements);
+  CsrMatrix<Coeff> matrix(basis.size(), basis.size(), elements);
+
+  auto expected = moments(
+      basis.size(), [&](std::span<const Coeff> x, std::span<Coeff> y) {
+        matrix.multiply(x, y);
+      });
+  auto result = moments(
+      engine.size(), [&](std::span<const Coeff> x, std::span<Coeff> y) {
+        engine.apply(x, y);
+      });
+  for (std::size_t k = 0; k < result.size(); k++) {
+    EXPECT_NEAR(std::abs(result[k] - expected[k]), 0.0, 1e-9);
+  }
+}
+
+TEST(HubbardEngineTest, DiagonalOnTheFly) {
+  auto model = HubbardChain(0.5, 1.0, 4.0, 6);
+  HubbardEngine stored = model.hubbard_engine(6, 3, 2);
+  HubbardEngine on_the_fly = model.hubbard_engine(
+      6, 3, 2, HubbardEngine::DiagonalStorage::OnTheFly);
+  EXPECT_TRUE(on_the_fly.diagonal().empty());
+
+  std::vector<Coeff> x(stored.size());
+  for (std::size_t i = 0; i < x.size(); i++) {
+    x[i] = Coeff(std::cos(static_cast<double>(i)), 0.1);
+  }
+  std::vector<Coeff> expected(x.size());
+  std::vector<Coeff> result(x.size());
+  stored.apply(x, expected);
+  on_the_fly.apply(x, result);
+  for (std::size_t i = 0; i < x.size(); i++) {
+    EXPECT_NEAR(std::abs(result[i] - expected[i]), 0.0, 1e-12);
+  }
+}
+
+TEST(HubbardEngineTest, RejectsUnsupportedTerms) {
+  auto c = [](Operator::Spin spin, std::size_t orbital) {
+    return Operator::annihilation<Fermion>(spin, orbital);
+  };
+  auto c_dagger = [](Operator::Spin spin, std::size_t orbital) {
+    return Operator::creation<Fermion>(spin, orbital);
+  };
+  const std::vector<Expression> unsupported = {
+      // Pair hopping, spin flip, a boson and an orbital out of range.
+      Expression({Term(1.0, {c_dagger(Up, 0), c_dagger(Down, 0), c(Down, 1),
+                             c(Up, 1)})}),
+      Expression({Term(1.0, {c_dagger(Up, 0), c(Down, 1)})}),
+      Expression({density<Boson>(1.0, Up, 0)}),
+      Expression({hopping<Fermion>(1.0, Up, 0, 2)}),
+  };
+  for (const Expression& hamiltonian : unsupported) {
+    EXPECT_THROW(HubbardEngine(2, 1, 1, hamiltonian), std::invalid_argument);
+  }
+
+  // Diagonal, but not made of densities.
+  const Expression exchange({Term(
+      1.0, {c_dagger(Up, 0), c(Up, 1), c_dagger(Up, 1), c(Up, 0)})});
+  EXPECT_NO_THROW(HubbardEngine(2, 1, 1, exchange));
+  EXPECT_THROW(
+      HubbardEngine(
+          2, 1, 1, exchange, HubbardEngine::DiagonalStorage::OnTheFly),
+      std::invalid_argument);
+}
+
+TEST(HubbardEngineTest, RejectsInvalidSizes) {
+  const Expression hamiltonian({hopping<Fermion>(1.0, Up, 0, 1)});
+  EXPECT_THROW(HubbardEngine(33, 1, 1, hamiltonian), std::invalid_argument);
+  EXPECT_THROW(HubbardEngine(2, 3, 1, hamiltonian), std::invalid_argument);
+  EXPECT_THROW(HubbardEngine(2, 1, 3, hamiltonian), std::invalid_argument);
+
+  const HubbardEngine engine(2, 1, 1, hamiltonian);
+  std::vector<Coeff> x(engine.size());
+  std::vector<Coeff> y(engine.size());
+  EXPECT_NO_THROW(engine.apply(x, y));
+  EXPECT_THROW(
+      engine.apply(x, std::span(y).first(y.size() - 1)),
+      std::invalid_argument);
+  x.push_back(0.0);
+  EXPECT_THROW(engine.apply(x, y), std::invalid_argument);
+}
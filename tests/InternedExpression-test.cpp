@@ -0,0 +1,115 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "InternedExpression.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "NormalOrderer.h"
+
+using enum Operator::Statistics;
+using enum Operator::Spin;
+
+TEST(OperatorStringTableTest, InternsEachStringOnce) {
+  OperatorStringTable table;
+  EXPECT_EQ(table.size(), 1);
+  EXPECT_TRUE(table.operators(OperatorStringTable::empty_id).empty());
+
+  const std::vector<Operator> a = {
+      Operator::creation<Fermion>(Up, 0),
+      Operator::annihilation<Fermion>(Down, 1)};
+  const std::vector<Operator> b = {Operator::creation<Fermion>(Down, 3)};
+
+  const auto id_a = table.intern(a);
+  const auto id_b = table.intern(b);
+  EXPECT_NE(id_a, id_b);
+  EXPECT_EQ(table.intern(a), id_a);
+  EXPECT_EQ(table.size(), 3);
+  EXPECT_EQ(table.find(b), id_b);
+  EXPECT_FALSE(table.find(std::vector<Operator>{a[1]}).has_value());
+
+  const auto ab = table.product(id_a, id_b);
+  EXPECT_EQ(table.product(id_a, id_b), ab);
+  EXPECT_EQ(table.product(id_a, OperatorStringTable::empty_id), id_a);
+  EXPECT_THAT(
+      table.operators(ab), testing::ElementsAre(a[0], a[1], b[0]));
+  EXPECT_EQ(table.size(), 4);
+}
+
+TEST(OperatorStringTableTest, NormalOrderMatchesNormalOrderer) {
+  OperatorStringTable table;
+  const std::vector<Operator> operators = {
+      Operator::annihilation<Fermion>(Up, 1),
+      Operator::creation<Fermion>(Up, 1),
+      Operator::creation<Fermion>(Down, 0)};
+  const auto& expansion = table.normal_order(table.intern(operators));
+
+  Expression result;
+  for (const auto& [id, coefficient] : expansion) {
+    auto ops = table.operators(id);
+    result += Term(coefficient, std::vector<Operator>(ops.begin(), ops.end()));
+  }
+  EXPECT_EQ(result, NormalOrderer(Term(1.0, operators)).expression());
+  EXPECT_EQ(&table.normal_order(table.intern(operators)), &expansion);
+
+  const auto a = table.intern(std::span(operators).first(1));
+  const auto b = table.intern(std::span(operators).subspan(1));
+  EXPECT_EQ(table.ordered_product(a, b), expansion);
+}
+
+TEST(OperatorStringTableTest, ClearMemoKeepsStrings) {
+  OperatorStringTable table;
+  const std::vector<Operator> operators = {
+      Operator::annihilation<Fermion>(Up, 1),
+      Operator::creation<Fermion>(Up, 1)};
+  const auto a = table.intern(std::span(operators).first(1));
+  const auto b = table.intern(std::span(operators).subspan(1));
+  const auto ab = table.product(a, b);
+  const auto expected = table.ordered_product(a, b);
+  table.normal_order(ab);
+  EXPECT_EQ(table.memo_size(), 3);
+  const std::size_t strings = table.size();
+
+  table.clear_memo();
+  EXPECT_EQ(table.memo_size(), 0);
+  EXPECT_EQ(table.size(), strings);
+  EXPECT_EQ(table.product(a, b), ab);
+  EXPECT_EQ(table.ordered_product(a, b), expected);
+  EXPECT_EQ(table.size(), strings);
+}
+
+TEST(InternedExpressionTest, RoundTrip) {
+  OperatorStringTable table;
+  const Expression expression = spin_x(0) * spin_y(1) + spin_z(2);
+  const InternedExpression interned(table, expression);
+  EXPECT_EQ(interned.size(), expression.size());
+  EXPECT_EQ(interned.expression(), expression);
+  EXPECT_EQ(InternedExpression(table, expression), interned);
+}
+
+TEST(InternedExpressionTest, CommutatorsMatchExpression) {
+  OperatorStringTable table;
+  Expression hamiltonian;
+  for (std::size_t i = 0; i < 4; i++) {
+    hamiltonian += spin_x(i) * spin_x((i + 1) % 4);
+    hamiltonian += spin_z(i) * spin_z((i + 1) % 4);
+    hamiltonian += hopping<Fermion>(2.0, Up, i, (i + 1) % 4);
+  }
+  const Expression sz = spin_z(1);
+  const InternedExpression h(table, hamiltonian);
+  const InternedExpression s(table, sz);
+
+  EXPECT_EQ(commute(h, s).expression(), commute(hamiltonian, sz));
+  EXPECT_EQ(anticommute(h, s).expression(), anticommute(hamiltonian, sz));
+  EXPECT_EQ(
+      h.product(s).normal_ordered().expression(),
+      NormalOrderer(hamiltonian * sz).expression());
+
+  // A second pass only hits the memoized products and orderings.
+  const std::size_t strings = table.size();
+  EXPECT_EQ(commute(h, s), commute(h, s));
+  EXPECT_EQ(table.size(), strings);
+}
@@ -3,9 +3,61 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
+
+#include "BasisFilter.h"
 #include "FermionicBasis.h"
+#include "Models/HubbardChain.h"
+#include "Models/HubbardSquare.h"
 #include "Models/LinearChain.h"
 #include "SparseMatrix.h"
+#include "SymmetricBasis.h"
+#include "TaskScheduler.h"
+
+using Matrix = std::vector<std::vector<std::complex<double>>>;
+
+static Matrix dense(
+    const SparseMatrix<std::complex<double>>& sparse, std::size_t size) {
+  Matrix result(size, std::vector<std::complex<double>>(size));
+  for (const auto& [index, value] : sparse.elements()) {
+    result[index.i][index.j] = value;
+  }
+  return result;
+}
+
+static Matrix multiply(const Matrix& a, const Matrix& b) {
+  Matrix result(a.size(), std::vector<std::complex<double>>(a.size()));
+  for (std::size_t i = 0; i < a.size(); i++) {
+    for (std::size_t k = 0; k < a.size(); k++) {
+      for (std::size_t j = 0; j < a.size(); j++) {
+        result[i][j] += a[i][k] * b[k][j];
+      }
+    }
+  }
+  return result;
+}
+
+static std::complex<double> trace(const Matrix& a) {
+  std::complex<double> result = 0.0;
+  for (std::size_t i = 0; i < a.size(); i++) {
+    result += a[i][i];
+  }
+  return result;
+}
+
+// tr(H), tr(H^2) and tr(H^3), which are invariant under a change of basis.
+static std::array<std::complex<double>, 3> moments(const Matrix& h) {
+  Matrix h2 = multiply(h, h);
+  return {trace(h), trace(h2), trace(multiply(h2, h))};
+}
+
+static void expect_hermitian(const Matrix& h) {
+  for (std::size_t i = 0; i < h.size(); i++) {
+    for (std::size_t j = 0; j < h.size(); j++) {
+      EXPECT_NEAR(std::abs(h[i][j] - std::conj(h[j][i])), 0.0, 1e-12);
+    }
+  }
+}
 
 TEST(ModelTest, LinearChain) {
   auto model = LinearChain(3, 1.0, 2.0);
@@ -27,3 +79,128 @@ TEST(ModelTest, LinearChain) {
     EXPECT_EQ(m((i + 2) % basis.size(), i), -1.0);
   }
 }
+
+TEST(ModelTest, HubbardChainReachableBasis) {
+  auto model = HubbardChain(0.0, 1.0, 2.0, 4);
+  std::vector<BasisElement> seeds = {
+      {Operator::creation<Fermion>(Up, 0), Operator::creation<Fermion>(Up, 1),
+       Operator::creation<Fermion>(Down, 2)}};
+  ReachableBasis reachable = model.reachable_basis(4, seeds);
+  FermionicBasis basis(4, 3, new TotalSpinFilter(-1));
+  EXPECT_EQ(reachable.elements(), basis.elements());
+
+  SparseMatrix<std::complex<double>> m1;
+  SparseMatrix<std::complex<double>> m2;
+  model.compute_matrix_elements(reachable, m1);
+  model.compute_matrix_elements(basis, m2);
+  EXPECT_EQ(m1, m2);
+}
+
+TEST(ModelTest, DeterministicAssembly) {
+  using Element = std::tuple<std::size_t, std::size_t, std::complex<double>>;
+  auto model = HubbardChain(0.3, 1.0, 2.0, 6);
+  FermionicBasis basis(6, 6);
+  auto assemble = [&](std::size_t threads) {
+    TaskScheduler scheduler(threads);
+    SparseMatrix<std::complex<double>> m;
+    model.compute_matrix_elements(
+        basis, m, HubbardChain::Assembly::Deterministic, scheduler);
+    // The iteration order of the hash map follows the insertion order.
+    std::vector<Element> result;
+    for (const auto& [index, value] : m.elements()) {
+      result.emplace_back(index.i, index.j, value);
+    }
+    return std::make_pair(m, result);
+  };
+
+  auto [m1, elements1] = assemble(1);
+  auto [m4, elements4] = assemble(4);
+  EXPECT_EQ(elements1, elements4);
+
+  SparseMatrix<std::complex<double>> unordered;
+  model.compute_matrix_elements(basis, unordered);
+  EXPECT_EQ(m1, unordered);
+}
+
+TEST(ModelTest, HubbardChainSymmetrySectors) {
+  // Half filling with Sz = 0, split by spin flip and particle-hole parity.
+  // The blocks are a change of basis of the full Hamiltonian, so the traces
+  // of its powers must add up.
+  auto model = HubbardChain(0.0, 1.0, 4.0, 4);
+  FermionicBasis basis(4, 4, new TotalSpinFilter(0));
+  SparseMatrix<std::complex<double>> m;
+  model.compute_matrix_elements(basis, m);
+  const auto expected = moments(dense(m, basis.size()));
+
+  std::size_t size = 0;
+  std::array<std::complex<double>, 3> sum = {};
+  for (int spin_parity : {1, -1}) {
+    for (int charge_parity : {1, -1}) {
+      SymmetricBasis sector(
+          4, 4,
+          spin_flip_symmetry(4, spin_parity) *
+              particle_hole_symmetry(checkerboard_signs(4), charge_parity),
+          new TotalSpinFilter(0));
+      SparseMatrix<std::complex<double>> block;
+      model.compute_matrix_elements(sector, block);
+      Matrix b = dense(block, sector.size());
+      expect_hermitian(b);
+
+      const auto block_moments = moments(b);
+      for (std::size_t k = 0; k < sum.size(); k++) {
+        sum[k] += block_moments[k];
+      }
+      size += sector.size();
+    }
+  }
+
+  EXPECT_EQ(size, basis.size());
+  for (std::size_t k = 0; k < sum.size(); k++) {
+    EXPECT_NEAR(std::abs(sum[k] - expected[k]), 0.0, 1e-9);
+  }
+}
+
+TEST(ModelTest, HubbardSquareSpaceGroupSectors) {
+  // Momentum sectors of a 3x3 torus. The zero momentum sector is split
+  // further by the rotations, the only momentum they leave invariant.
+  HubbardSquare model(1.0, 4.0, 3, 3);
+  FermionicBasis basis(9, 3, new TotalSpinFilter(1));
+  SparseMatrix<std::complex<double>> m;
+  model.compute_matrix_elements(basis, m);
+  const auto expected = moments(dense(m, basis.size()));
+
+  std::vector<SymmetryGroup> sectors;
+  for (std::size_t kx = 0; kx < 3; kx++) {
+    for (std::size_t ky = 0; ky < 3; ky++) {
+      SymmetryGroup translations = translation_symmetry(3, 3, kx, ky);
+      if (kx == 0 && ky == 0) {
+        for (int l = 0; l < 4; l++) {
+          sectors.push_back(translations * rotation_symmetry(3, l));
+        }
+      } else {
+        sectors.push_back(translations);
+      }
+    }
+  }
+
+  std::size_t size = 0;
+  std::array<std::complex<double>, 3> sum = {};
+  for (const SymmetryGroup& group : sectors) {
+    SymmetricBasis sector(9, 3, group, new TotalSpinFilter(1));
+    SparseMatrix<std::complex<double>> block;
+    model.compute_matrix_elements(sector, block);
+    Matrix b = dense(block, sector.size());
+    expect_hermitian(b);
+
+    const auto block_moments = moments(b);
+    for (std::size_t k = 0; k < sum.size(); k++) {
+      sum[k] += block_moments[k];
+    }
+    size += sector.size();
+  }
+
+  EXPECT_EQ(size, basis.size());
+  for (std::size_t k = 0; k < sum.size(); k++) {
+    EXPECT_NEAR(std::abs(sum[k] - expected[k]), 0.0, 1e-9);
+  }
+}
@@ -0,0 +1,108 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "NestedCommutator.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "NormalOrderer.h"
+
+using enum Operator::Statistics;
+using enum Operator::Spin;
+
+TEST(NestedCommutatorTest, MatchesRepeatedCommute) {
+  Expression s;
+  Expression h;
+  for (std::size_t i = 0; i < 3; i++) {
+    s += hopping<Fermion>(0.5, Up, i, i + 1);
+    h += spin_z(i) * spin_z(i + 1);
+  }
+
+  const auto series = nested_commutators(s, h, 3);
+  ASSERT_EQ(series.size(), 4);
+  EXPECT_EQ(series[0], h);
+  Expression expected = h;
+  for (std::size_t k = 1; k < series.size(); k++) {
+    expected = commute(s, expected).product(1.0 / static_cast<double>(k));
+    EXPECT_EQ(series[k], expected);
+  }
+  EXPECT_EQ(parallel_commute(s, h), commute(s, h));
+}
+
+TEST(NestedCommutatorTest, ParallelCommuteSplitsTheTerms) {
+  Expression s;
+  Expression h;
+  for (std::size_t i = 0; i < 32; i++) {
+    s += hopping<Fermion>(0.5, Up, i, (i + 1) % 32);
+    s += hopping<Fermion>(0.5, Down, i, (i + 1) % 32);
+    s += spin_z(i) * spin_z((i + 2) % 32);
+    h += spin_x(i) * spin_x((i + 1) % 32);
+    h += spin_z(i) * spin_z((i + 1) % 32);
+    h += hopping<Fermion>(-1.0, Down, i, (i + 3) % 32);
+  }
+  TaskScheduler parallel(4);
+  ASSERT_EQ(Expression::product_chunks(s.size() * h.size(), parallel), 4);
+
+  const Expression expected = commute(s, h);
+  EXPECT_EQ(parallel_commute(s, h, parallel), expected);
+  const auto series = nested_commutators(s, h, 1, parallel);
+  ASSERT_EQ(series.size(), 2);
+  EXPECT_EQ(series[1], expected);
+}
+
+TEST(NestedCommutatorTest, StopsWhenAnOrderVanishes) {
+  // [S, n_1] = S and [S, S] = 0 for S = b+_0 b_1. The terms of [S, S]
+  // cancel exactly, and are only dropped with a tolerance.
+  const Expression s({one_body<Boson>(1.0, Up, 0, Up, 1)});
+  const Expression n({density<Boson>(1.0, Up, 1)});
+  Expression truncated_s = s;
+  truncated_s.set_tolerance(1e-12);
+
+  const auto series = nested_commutators(truncated_s, n, 10);
+  EXPECT_EQ(series.size(), 2);
+  EXPECT_EQ(bch_transform(truncated_s, n, 10), n + s);
+}
+
+TEST(NestedCommutatorTest, KeepsTheWeightOfATruncatedOrder) {
+  // [S, n_0] is of order a, and [S, [S, n_0]] of order a^2, which falls
+  // below the tolerance.
+  const double a = 0.02;
+  Expression s = hopping<Fermion>(a, Up, 0, 1);
+  s.set_tolerance(1e-3);
+  const Expression n({density<Fermion>(1.0, Up, 0)});
+
+  const auto series = nested_commutators(s, n, 10);
+  ASSERT_EQ(series.size(), 3);
+  EXPECT_GT(series[1].size(), 0);
+  EXPECT_EQ(series[2].size(), 0);
+  const double dropped = commute(s, series[1]).discarded();
+  EXPECT_GT(dropped, 0.0);
+  EXPECT_DOUBLE_EQ(series[2].discarded(), dropped / 2.0);
+
+  const Expression transformed = bch_transform(s, n, 10);
+  EXPECT_EQ(transformed, n + series[1]);
+  EXPECT_DOUBLE_EQ(
+      transformed.discarded(), series[1].discarded() + dropped / 2.0);
+}
+
+TEST(NestedCommutatorTest, SpinRotation) {
+  // [sz, c+(Up) c(Down)] = 2 c+(Up) c(Down), so e^{ia sz} rotates the
+  // coefficient of c+(Up) c(Down) in sx to e^{2ia}. Terms that vanish by
+  // the exclusion principle are not simplified, and are left out here.
+  const double angle = 0.3;
+  Expression s = spin_z(0);
+  s *= std::complex<double>(0.0, angle);
+  s.set_tolerance(1e-14);
+  const Expression rotated = bch_transform(s, spin_x(0), 30);
+
+  const std::vector<Operator> flip = {
+      Operator::creation<Fermion>(Up, 0),
+      Operator::annihilation<Fermion>(Down, 0)};
+  const auto expected = std::exp(std::complex<double>(0.0, 2.0 * angle));
+  EXPECT_NEAR(std::abs(rotated.terms().at(flip) - expected), 0.0, 1e-12);
+}
@@ -5,6 +5,7 @@
 #include <gtest/gtest.h>
 
 #include "NormalOrderer.h"
+#include "TaskScheduler.h"
 
 using testing::IsEmpty;
 
@@ -660,3 +661,57 @@ TEST(DISABLED_NormalOrderTest, NormalOrderOutofOrderCaseWithoutIndex) {
   Term term(1.0, operators);
   Expression e = NormalOrderer(term).expression();
 }
+
+TEST(NormalOrderTest, NormalOrderedProduct) {
+  Expression small = spin_x(0) + hopping<Fermion>(1.0, Up, 0, 1);
+  EXPECT_EQ(
+      normal_ordered_product(small, spin_z(1)),
+      NormalOrderer(small * spin_z(1)).expression());
+
+  // Large enough to be computed in parallel.
+  Expression large;
+  for (std::size_t i = 0; i < 32; i++) {
+    large += spin_x(i) * spin_x((i + 1) % 32);
+    large += spin_z(i) * spin_z((i + 1) % 32);
+    large += hopping<Fermion>(-1.0, Down, i, (i + 1) % 32);
+  }
+  TaskScheduler scheduler(4);
+  ASSERT_EQ(
+      Expression::product_chunks(large.size() * large.size(), scheduler), 4);
+  const Expression expected = NormalOrderer(large * large).expression();
+  EXPECT_EQ(normal_ordered_product(large, large, scheduler), expected);
+  EXPECT_EQ(normal_ordered_product(large, large), expected);
+}
+
+TEST(NormalOrderTest, ToleranceDropsNegligibleTerms) {
+  Expression h;
+  Expression small;
+  for (std::size_t i = 0; i < 4; i++) {
+    h += spin_x(i) * spin_x(i + 1);
+    small += 1e-8 * (spin_z(i) * spin_z(i + 2));
+  }
+  const Expression sz = spin_z(0);
+
+  Expression truncated = h + small;
+  truncated.set_tolerance(1e-6);
+  EXPECT_DOUBLE_EQ(truncated.discarded(), 4 * 4 * 1e-8);
+
+  // The small terms are gone before the commutator is taken, and the terms
+  // that cancel are dropped.
+  const Expression c = commute(truncated, spin_x(2));
+  EXPECT_EQ(c.tolerance(), 1e-6);
+  Expression expected = commute(h, spin_x(2));
+  EXPECT_LT(c.size(), expected.size());
+  expected.set_tolerance(1e-6);
+  EXPECT_EQ(c, expected);
+
+  // Normal ordering skips the small terms, and reports them.
+  NormalOrderer orderer(1e-6);
+  orderer.insert(h + small);
+  EXPECT_EQ(orderer.expression(), NormalOrderer(h).expression());
+  EXPECT_DOUBLE_EQ(orderer.discarded(), 4 * 4 * 1e-8);
+  EXPECT_DOUBLE_EQ(orderer.expression().discarded(), 4 * 4 * 1e-8);
+  EXPECT_EQ(
+      normal_ordered_product(truncated, sz),
+      NormalOrderer(h * sz).expression());
+}
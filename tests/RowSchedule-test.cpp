@@ -0,0 +1,70 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "RowSchedule.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using enum Operator::Statistics;
+using enum Operator::Spin;
+
+TEST(RowScheduleTest, CostModelCountsHops) {
+  Expression hamiltonian;
+  for (std::size_t i = 0; i < 3; i++) {
+    hamiltonian += hopping<Fermion>(-1.0, Up, i, i + 1);
+  }
+  RowCostModel cost(hamiltonian);
+  // Six terms. An up electron on 0 can only hop to 1, one on 1 to 0 or 2.
+  EXPECT_DOUBLE_EQ(cost(0b00000001), 7.0);
+  EXPECT_DOUBLE_EQ(cost(0b00000100), 8.0);
+  // With both occupied only 1 -> 2 remains.
+  EXPECT_DOUBLE_EQ(cost(0b00000101), 7.0);
+  // Down electrons do not hop.
+  EXPECT_DOUBLE_EQ(cost(0b00000010), 6.0);
+}
+
+TEST(RowScheduleTest, ChunksCoverRows) {
+  std::vector<double> costs(100, 1.0);
+  costs[17] = 1000.0;
+  RowSchedule schedule(costs, 8);
+
+  std::vector<std::pair<std::size_t, std::size_t>> chunks;
+  for (std::size_t k = 0; k < schedule.size(); k++) {
+    chunks.push_back(schedule.chunk(k));
+  }
+  // The expensive row comes first, on its own.
+  EXPECT_EQ(chunks.front(), std::make_pair(17ul, 18ul));
+
+  std::sort(chunks.begin(), chunks.end());
+  std::size_t next = 0;
+  for (const auto& [first, last] : chunks) {
+    EXPECT_EQ(first, next);
+    EXPECT_LT(first, last);
+    next = last;
+  }
+  EXPECT_EQ(next, costs.size());
+}
+
+TEST(RowScheduleTest, BalancedChunks) {
+  std::vector<double> costs(1000);
+  for (std::size_t i = 0; i < costs.size(); i++) {
+    costs[i] = static_cast<double>(i % 10);
+  }
+  RowSchedule schedule(costs, 10);
+  EXPECT_EQ(schedule.size(), 10);
+  for (std::size_t k = 0; k < schedule.size(); k++) {
+    auto [first, last] = schedule.chunk(k);
+    double sum = 0.0;
+    for (std::size_t i = first; i < last; i++) {
+      sum += costs[i];
+    }
+    EXPECT_NEAR(sum, 450.0, 9.0);
+  }
+
+  RowSchedule empty(std::vector<double>{}, 4);
+  EXPECT_EQ(empty.size(), 0);
+  RowSchedule zero(std::vector<double>(6, 0.0), 3);
+  EXPECT_EQ(zero.size(), 3);
+}
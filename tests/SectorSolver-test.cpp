@@ -0,0 +1,130 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "SectorSolver.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+
+#include "BasisFilter.h"
+#include "FermionicBasis.h"
+#include "Lanczos.h"
+#include "Models/HubbardChain.h"
+#include "SymmetricBasis.h"
+
+using Coeff = Term::CoeffType;
+
+TEST(SectorSolverTest, LanczosDiagonal) {
+  const std::size_t size = 50;
+  auto multiply = [](std::span<const Coeff> x, std::span<Coeff> y) {
+    for (std::size_t i = 0; i < x.size(); i++) {
+      y[i] = (static_cast<double>(i % 7) - 2.5) * x[i];
+    }
+  };
+  EXPECT_NEAR(lowest_eigenvalue(size, multiply), -2.5, 1e-10);
+  EXPECT_NEAR(lowest_eigenvalue(1, multiply), -2.5, 1e-10);
+}
+
+TEST(SectorSolverTest, FreeFermionRing) {
+  // Single particle energies -2 cos(2 pi k / 6) = -2, -1, -1, 1, 1, 2.
+  HubbardChain model(0.0, 1.0, 0.0, 6);
+  TaskScheduler scheduler(3);
+  SectorSolver solver(scheduler);
+  for (std::size_t particles = 0; particles <= 4; particles++) {
+    solver.add(model, [particles]() {
+      return std::make_unique<FermionicBasis>(6, particles);
+    });
+  }
+  auto results = solver.run();
+  ASSERT_EQ(results.size(), 5);
+  EXPECT_EQ(solver.size(), 0);
+  const std::vector<double> expected = {0.0, -2.0, -4.0, -5.0, -6.0};
+  for (std::size_t k = 0; k < results.size(); k++) {
+    EXPECT_NEAR(results[k].value, expected[k], 1e-9) << k;
+  }
+  EXPECT_EQ(results[2].size, 66);
+}
+
+TEST(SectorSolverTest, SymmetrySectors) {
+  HubbardChain model(0.5, 1.0, 4.0, 6);
+  SectorSolver solver;
+  const std::size_t full = solver.add(model, []() {
+    return std::make_unique<FermionicBasis>(6, 4, new TotalSpinFilter(0));
+  });
+  for (std::size_t k = 0; k < 6; k++) {
+    solver.add(model, [k]() {
+      return std::make_unique<SymmetricBasis>(
+          6, 4, translation_symmetry(6, 1, k, 0), new TotalSpinFilter(0));
+    });
+  }
+  auto results = solver.run();
+
+  double lowest = results[1].value;
+  std::size_t size = 0;
+  for (std::size_t k = 1; k < results.size(); k++) {
+    lowest = std::min(lowest, results[k].value);
+    size += results[k].size;
+  }
+  EXPECT_EQ(size, results[full].size);
+  EXPECT_NEAR(lowest, results[full].value, 1e-9);
+}
+
+TEST(SectorSolverTest, CustomSolver) {
+  HubbardChain model(0.0, 1.0, 2.0, 4);
+  SectorSolver solver(
+      [](const CsrMatrix<Coeff>& matrix) {
+        return static_cast<double>(matrix.nonzeros());
+      },
+      TaskScheduler::instance());
+  solver.add(model, []() {
+    return std::make_unique<FermionicBasis>(4, 2);
+  });
+  auto results = solver.run();
+  EXPECT_EQ(results[0].size, 28);
+  EXPECT_GT(results[0].value, 28.0);
+}
+
+TEST(SectorSolverTest, SharedBasis) {
+  // The same sector for several interactions, generated once, on the pool
+  // of the solver.
+  std::vector<std::unique_ptr<HubbardChain>> models;
+  std::vector<const Model*> pointers;
+  for (double u : {0.0, 2.0, 4.0}) {
+    models.push_back(std::make_unique<HubbardChain>(0.0, 1.0, u, 6));
+    pointers.push_back(models.back().get());
+  }
+  TaskScheduler scheduler(4);
+  std::atomic<int> bases{0};
+  std::atomic<int> elsewhere{0};
+  auto make_basis = [&]() {
+    bases++;
+    if (&TaskScheduler::current() != &scheduler) {
+      elsewhere++;
+    }
+    return std::make_unique<FermionicBasis>(6, 4, new TotalSpinFilter(0));
+  };
+
+  SectorSolver separate(scheduler);
+  for (const Model* model : pointers) {
+    separate.add(*model, make_basis);
+  }
+  const auto expected = separate.run();
+  EXPECT_EQ(bases.load(), 3);
+
+  SectorSolver shared(scheduler);
+  EXPECT_EQ(shared.add(pointers, make_basis), 0);
+  EXPECT_EQ(shared.add(*models[0], make_basis), 3);
+  EXPECT_EQ(shared.size(), 4);
+  const auto results = shared.run();
+  EXPECT_EQ(bases.load(), 5);
+  EXPECT_EQ(elsewhere.load(), 0);
+
+  ASSERT_EQ(results.size(), 4);
+  for (std::size_t k = 0; k < 3; k++) {
+    EXPECT_EQ(results[k].size, expected[k].size);
+    EXPECT_NEAR(results[k].value, expected[k].value, 1e-9) << k;
+  }
+  EXPECT_NEAR(results[3].value, expected[0].value, 1e-9);
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "SortedExpression.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+using enum Operator::Statistics;
+using enum Operator::Spin;
+
+static Expression chain(std::size_t size, std::size_t offset) {
+  Expression result;
+  for (std::size_t i = offset; i < offset + size; i++) {
+    result += spin_x(i) * spin_x(i + 1);
+    result += hopping<Fermion>(-1.0, Up, i, i + 1);
+  }
+  return result;
+}
+
+TEST(SortedExpressionTest, RoundTripIsSorted) {
+  const Expression expression = chain(4, 0);
+  const SortedExpression sorted(expression);
+  EXPECT_EQ(sorted.size(), expression.size());
+  EXPECT_EQ(sorted.expression(), expression);
+  for (std::size_t i = 1; i < sorted.size(); i++) {
+    const auto a = sorted.operators(i - 1);
+    const auto b = sorted.operators(i);
+    EXPECT_TRUE(
+        std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end()));
+  }
+
+  const std::vector<Operator> density = {
+      Operator::creation<Fermion>(Up, 1),
+      Operator::annihilation<Fermion>(Up, 2)};
+  EXPECT_EQ(sorted.coefficient(density), Term::CoeffType(-1.0));
+  EXPECT_EQ(
+      sorted.coefficient(std::vector<Operator>{density[0]}),
+      Term::CoeffType(0.0));
+  EXPECT_TRUE(SortedExpression().empty());
+}
+
+TEST(SortedExpressionTest, AlgebraMatchesExpression) {
+  const Expression a = chain(4, 0);
+  const Expression b = chain(4, 2);
+  const SortedExpression sa(a);
+  const SortedExpression sb(b);
+
+  EXPECT_EQ((sa + sb).expression(), a + b);
+  EXPECT_EQ(sa + sb, SortedExpression(a + b));
+  EXPECT_EQ((2.5 * sa).expression(), a.product(2.5));
+  EXPECT_EQ(sa.negate().expression(), a.negate());
+
+  SortedExpression sum = sa;
+  sum += sb;
+  sum *= Term::CoeffType(0.0, 1.0);
+  Expression expected = a + b;
+  expected *= Term::CoeffType(0.0, 1.0);
+  EXPECT_EQ(sum.expression(), expected);
+
+  EXPECT_EQ(sa, SortedExpression(a));
+  EXPECT_NE(sa, sb);
+  EXPECT_NE(sa, 2.0 * sa);
+}
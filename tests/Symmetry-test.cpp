@@ -0,0 +1,171 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "Symmetry.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "BasisFilter.h"
+#include "FermionicBasis.h"
+#include "SymmetricBasis.h"
+
+using Phase = SymmetryOperation::Phase;
+
+// Every operation applied twice to all states of (orbitals, particles).
+static void expect_involution(
+    const SymmetryOperation& op, std::size_t orbitals, std::size_t particles) {
+  FermionicBasis basis(orbitals, particles);
+  for (const BasisElement& element : basis.elements()) {
+    const std::uint64_t word = occupation_bits(element);
+    auto [image, phase] = op.apply(word);
+    auto [back, phase_back] = op.apply(image);
+    EXPECT_EQ(back, word);
+    EXPECT_NEAR(std::abs(phase * phase_back - Phase(1.0)), 0.0, 1e-12);
+  }
+}
+
+TEST(SymmetryOperationTest, SitePermutation) {
+  // c+(0, Up) c+(1, Down) -> c+(1, Up) c+(0, Down) = -c+(0, Down) c+(1, Up)
+  auto swap = SymmetryOperation::site_permutation({1, 0});
+  auto [image, phase] = swap.apply(0b1001);
+  EXPECT_EQ(image, 0b0110);
+  EXPECT_EQ(phase, Phase(-1.0));
+}
+
+TEST(SymmetryOperationTest, SpinFlip) {
+  auto flip = SymmetryOperation::spin_flip(2);
+  // A doubly occupied orbital changes sign.
+  auto [image, phase] = flip.apply(0b0011);
+  EXPECT_EQ(image, 0b0011);
+  EXPECT_EQ(phase, Phase(-1.0));
+  expect_involution(SymmetryOperation::spin_flip(3), 3, 3);
+}
+
+TEST(SymmetryOperationTest, ParticleHole) {
+  for (std::size_t orbitals : {2ul, 3ul, 4ul}) {
+    auto op = SymmetryOperation::particle_hole(checkerboard_signs(orbitals));
+    auto [image, phase] = op.apply(0);
+    EXPECT_EQ(image, (std::uint64_t{1} << (2 * orbitals)) - 1);
+    expect_involution(op, orbitals, orbitals);
+  }
+}
+
+TEST(SymmetryOperationTest, Composition) {
+  auto flip = SymmetryOperation::spin_flip(2);
+  auto swap = SymmetryOperation::site_permutation({1, 0});
+  auto [first, first_phase] = flip.apply(0b0001);
+  auto [second, second_phase] = swap.apply(first);
+  auto [image, phase] = (swap * flip).apply(0b0001);
+  EXPECT_EQ(image, second);
+  EXPECT_EQ(phase, first_phase * second_phase);
+}
+
+TEST(SymmetryGroupTest, DirectProduct) {
+  auto group = spin_flip_symmetry(4, -1) *
+               particle_hole_symmetry(checkerboard_signs(4), -1);
+  ASSERT_EQ(group.size(), 4);
+  EXPECT_EQ(group.character(0), Phase(1.0));
+  EXPECT_EQ(group.character(1), Phase(-1.0));
+  EXPECT_EQ(group.character(2), Phase(-1.0));
+  EXPECT_EQ(group.character(3), Phase(1.0));
+}
+
+TEST(SymmetricBasisTest, SpinFlipSectors) {
+  // Four particles with Sz = 0 on four orbitals: the six states with two
+  // doubly occupied orbitals are even under spin flip, the other thirty
+  // pair up.
+  SymmetricBasis even(4, 4, spin_flip_symmetry(4, 1), new TotalSpinFilter(0));
+  SymmetricBasis odd(4, 4, spin_flip_symmetry(4, -1), new TotalSpinFilter(0));
+  EXPECT_EQ(even.size(), 21);
+  EXPECT_EQ(odd.size(), 15);
+
+  FermionicBasis full(4, 4, new TotalSpinFilter(0));
+  for (const BasisElement& element : full.elements()) {
+    const bool in_even = even.find(element).has_value();
+    const bool in_odd = odd.find(element).has_value();
+    EXPECT_TRUE(in_even || in_odd);
+  }
+}
+
+TEST(SymmetricBasisTest, TrivialGroup) {
+  SymmetricBasis basis(4, 3, SymmetryGroup(), new TotalSpinFilter(1));
+  FermionicBasis expected(4, 3, new TotalSpinFilter(1));
+  EXPECT_EQ(basis.elements(), expected.elements());
+  for (std::size_t i = 0; i < basis.size(); i++) {
+    EXPECT_DOUBLE_EQ(basis.overlap(i), 1.0);
+    auto found = basis.find(expected.element(i));
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->first, i);
+  }
+}
+
+TEST(SymmetricBasisTest, MomentumSectorsCoverBasis) {
+  FermionicBasis full(4, 2);
+  std::size_t size = 0;
+  for (std::size_t k = 0; k < 4; k++) {
+    size += SymmetricBasis(4, 2, translation_symmetry(4, 1, k, 0)).size();
+  }
+  EXPECT_EQ(size, full.size());
+}
+
+TEST(SymmetricBasisTest, RejectsGroupsThatChangeTheBasis) {
+  // Particle-hole conjugation only preserves half filling.
+  const auto particle_hole = particle_hole_symmetry(checkerboard_signs(4), 1);
+  EXPECT_NO_THROW(SymmetricBasis(4, 4, particle_hole));
+  EXPECT_THROW(SymmetricBasis(4, 3, particle_hole), std::invalid_argument);
+  EXPECT_THROW(
+      SymmetricBasis(5, 5, particle_hole_symmetry(checkerboard_signs(4), 1)),
+      std::invalid_argument);
+  // Applied twice, it conserves any number of particles.
+  const auto op = SymmetryOperation::particle_hole(checkerboard_signs(4));
+  SymmetryGroup twice;
+  twice.add(op * op, 1.0);
+  EXPECT_NO_THROW(SymmetricBasis(4, 3, twice));
+  // Permutations of a different number of sites.
+  EXPECT_THROW(
+      SymmetricBasis(4, 2, translation_symmetry(3, 1, 0, 0)),
+      std::invalid_argument);
+  EXPECT_THROW(
+      SymmetricBasis(4, 2, spin_flip_symmetry(5, 1)), std::invalid_argument);
+}
+
+TEST(SymmetryGroupTest, PointGroups) {
+  EXPECT_EQ(inversion_symmetry(4, 2, -1).size(), 2);
+  for (int m = 0; m < 4; m++) {
+    EXPECT_EQ(rotation_symmetry(4, m).size(), 4);
+  }
+  for (D4Irrep irrep : {D4Irrep::A1, D4Irrep::A2, D4Irrep::B1, D4Irrep::B2}) {
+    EXPECT_EQ(d4_symmetry(4, irrep).size(), 8);
+  }
+  EXPECT_EQ(
+      (translation_symmetry(4, 4, 2, 2) * d4_symmetry(4, D4Irrep::B1)).size(),
+      128);
+}
+
+TEST(SymmetryGroupTest, SitePermutationGroup) {
+  // The reflection of three sites in a row, odd under the reflection.
+  const std::vector<std::vector<std::size_t>> reflection = {
+      {0, 1, 2}, {2, 1, 0}};
+  EXPECT_EQ(site_permutation_group(reflection, {1.0, -1.0}).size(), 2);
+
+  EXPECT_THROW(
+      site_permutation_group(reflection, {1.0}), std::invalid_argument);
+  // Not multiplicative: the reflection squared has character 1.
+  EXPECT_THROW(
+      site_permutation_group(reflection, {1.0, Phase(0.0, 1.0)}),
+      std::invalid_argument);
+  // Missing the identity, not closed, and not permutations.
+  EXPECT_THROW(
+      site_permutation_group({{2, 1, 0}}, {1.0}), std::invalid_argument);
+  EXPECT_THROW(
+      site_permutation_group({{0, 1, 2}, {1, 2, 0}}, {1.0, 1.0}),
+      std::invalid_argument);
+  EXPECT_THROW(
+      site_permutation_group({{0, 1, 2}, {2, 2, 0}}, {1.0, 1.0}),
+      std::invalid_argument);
+  EXPECT_THROW(
+      site_permutation_group({{0, 1, 2}, {1, 0}}, {1.0, 1.0}),
+      std::invalid_argument);
+}
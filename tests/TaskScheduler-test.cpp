@@ -0,0 +1,102 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#include "TaskScheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+
+TEST(TaskSchedulerTest, ParallelFor) {
+  for (std::size_t concurrency : {1ul, 2ul, 4ul}) {
+    TaskScheduler scheduler(concurrency);
+    EXPECT_EQ(scheduler.concurrency(), concurrency);
+    std::vector<int> visits(1000, 0);
+    scheduler.parallel_for(0, visits.size(), 7, [&](std::size_t i) {
+      visits[i]++;
+    });
+    EXPECT_EQ(std::count(visits.begin(), visits.end(), 1), visits.size());
+  }
+}
+
+TEST(TaskSchedulerTest, NestedGroups) {
+  // Tasks that wait for their own tasks, deeper than there are threads.
+  TaskScheduler scheduler(3);
+  std::atomic<std::size_t> leaves{0};
+  std::function<void(std::size_t)> spawn = [&](std::size_t depth) {
+    if (depth == 0) {
+      leaves++;
+      return;
+    }
+    TaskGroup group(scheduler);
+    for (int k = 0; k < 3; k++) {
+      group.run([&spawn, depth]() { spawn(depth - 1); });
+    }
+    group.wait();
+  };
+  spawn(6);
+  EXPECT_EQ(leaves.load(), 729);
+}
+
+TEST(TaskSchedulerTest, IrregularTasks) {
+  TaskScheduler scheduler(4);
+  std::vector<std::uint64_t> sums(64, 0);
+  {
+    TaskGroup group(scheduler);
+    for (std::size_t k = 0; k < sums.size(); k++) {
+      group.run([&sums, k]() {
+        for (std::uint64_t i = 0; i < (k % 8) * 10000; i++) {
+          sums[k] += i;
+        }
+      });
+    }
+  }
+  for (std::size_t k = 0; k < sums.size(); k++) {
+    const std::uint64_t n = (k % 8) * 10000;
+    EXPECT_EQ(sums[k], n == 0 ? 0 : n * (n - 1) / 2);
+  }
+}
+
+TEST(TaskSchedulerTest, ExceptionsReachWait) {
+  TaskScheduler scheduler(4);
+  std::atomic<std::size_t> done{0};
+  TaskGroup group(scheduler);
+  for (std::size_t k = 0; k < 16; k++) {
+    group.run([&done, k]() {
+      if (k % 5 == 0) {
+        throw std::runtime_error("task failed");
+      }
+      done++;
+    });
+  }
+  EXPECT_THROW(group.wait(), std::runtime_error);
+  // The other tasks still ran, and the exception was rethrown once.
+  EXPECT_EQ(done.load(), 12);
+  EXPECT_NO_THROW(group.wait());
+
+  EXPECT_THROW(
+      scheduler.parallel_for(
+          0, 1000, 1,
+          [](std::size_t i) {
+            if (i == 999) {
+              throw std::runtime_error("index failed");
+            }
+          }),
+      std::runtime_error);
+}
+
+TEST(TaskSchedulerTest, CurrentIsThePoolOfTheTask) {
+  TaskScheduler scheduler(4);
+  EXPECT_EQ(&TaskScheduler::current(), &TaskScheduler::instance());
+  std::atomic<std::size_t> elsewhere{0};
+  scheduler.parallel_for(0, 100, 1, [&](std::size_t) {
+    if (&TaskScheduler::current() != &scheduler) {
+      elsewhere++;
+    }
+  });
+  EXPECT_EQ(elsewhere.load(), 0);
+  EXPECT_EQ(&TaskScheduler::current(), &TaskScheduler::instance());
+}
@@ -0,0 +1,23 @@
+// Copyright (c) 2024 Matheus Sousa
+// SPDX-License-Identifier: BSD-2-Clause
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <string>
+
+// A path in the temporary directory that is unique to the running test and
+// process, so that test binaries run in parallel do not share files.
+inline std::string temporary_path(const std::string& name) {
+  const testing::TestInfo* test =
+      testing::UnitTest::GetInstance()->current_test_info();
+  std::string unique = "libmb-" + std::to_string(getpid());
+  if (test != nullptr) {
+    unique += std::string("-") + test->test_suite_name() + "-" + test->name();
+  }
+  return (std::filesystem::temp_directory_path() / (unique + "-" + name))
+      .string();
+}